@@ -87,6 +87,12 @@ public:
         next_free_ = index;
     }
 
+    //! ensure that at least @p n blocks can be allocated without the
+    //! underlying storage being reallocated.
+    void reserve(size_t const n) {
+        data_.reserve(data_.size() + n);
+    }
+
     size_t capacity() const noexcept { return data_.size(); }
 
     T&       operator[](size_t const i)       noexcept { return data_[i - 1].data; }
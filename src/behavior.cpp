@@ -0,0 +1,238 @@
+#include "behavior.hpp"
+#include "config.hpp"
+#include "hash.hpp"
+#include "random.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+
+namespace boken {
+
+behavior_decision behavior_program::run(
+    behavior_inputs const& in
+  , random_state&          rng
+) const noexcept {
+    BK_ASSERT(!code_.empty());
+
+    auto const* const code = code_.data();
+
+    for (size_t pc = 0; ; ) {
+        auto const& i = code[pc];
+
+        bool ok = false;
+        switch (i.code) {
+        case op::chance:        ok = random_chance_in_x(rng, i.arg, 100); break;
+        case op::player_within: ok = in.player_distance <= i.arg;         break;
+        case op::player_beyond: ok = in.player_distance >  i.arg;         break;
+        case op::other_within:  ok = in.other_distance  <= i.arg;         break;
+        case op::other_beyond:  ok = in.other_distance  >  i.arg;         break;
+        case op::scent_above:   ok = in.scent           >  i.arg;         break;
+        case op::noise_above:   ok = in.noise           >  i.arg;         break;
+        case op::act:           return {i.action, i.arg};
+        default:
+            BK_ASSERT(false);
+            return {behavior_action::wait, 1};
+        }
+
+        pc = ok ? pc + 1 : i.fail;
+    }
+}
+
+namespace {
+
+std::vector<std::string> split_words(std::string const& s) {
+    std::vector<std::string> result;
+
+    auto const is_space = [](char const c) noexcept {
+        return c == ' ' || c == '\t';
+    };
+
+    for (auto it = begin(s); it != end(s); ) {
+        auto const first = std::find_if_not(it, end(s), is_space);
+        auto const last  = std::find_if(first, end(s), is_space);
+        if (first != last) {
+            result.emplace_back(first, last);
+        }
+        it = last;
+    }
+
+    return result;
+}
+
+bool parse_number(std::string const& s, int32_t& out) noexcept {
+    if (s.empty()) {
+        return false;
+    }
+
+    char* last = nullptr;
+    auto const n = std::strtol(s.c_str(), &last, 10);
+    if (*last != '\0' || n < 0 || n > std::numeric_limits<int32_t>::max()) {
+        return false;
+    }
+
+    out = static_cast<int32_t>(n);
+    return true;
+}
+
+bool to_condition(std::string const& s, behavior_program::op& out) noexcept {
+    using op = behavior_program::op;
+
+    switch (djb2_hash_32(s.data(), s.data() + s.size())) {
+    case djb2_hash_32c("chance")        : out = op::chance;        return true;
+    case djb2_hash_32c("player_within") : out = op::player_within; return true;
+    case djb2_hash_32c("player_beyond") : out = op::player_beyond; return true;
+    case djb2_hash_32c("other_within")  : out = op::other_within;  return true;
+    case djb2_hash_32c("other_beyond")  : out = op::other_beyond;  return true;
+    case djb2_hash_32c("scent_above")   : out = op::scent_above;   return true;
+    case djb2_hash_32c("noise_above")   : out = op::noise_above;   return true;
+    default                             : break;
+    }
+
+    return false;
+}
+
+bool to_action(std::string const& s, behavior_action& out) noexcept {
+    using ba = behavior_action;
+
+    switch (djb2_hash_32(s.data(), s.data() + s.size())) {
+    case djb2_hash_32c("wait")            : out = ba::wait;            return true;
+    case djb2_hash_32c("wander")          : out = ba::wander;          return true;
+    case djb2_hash_32c("approach_player") : out = ba::approach_player; return true;
+    case djb2_hash_32c("flee_player")     : out = ba::flee_player;     return true;
+    case djb2_hash_32c("approach_other")  : out = ba::approach_other;  return true;
+    case djb2_hash_32c("follow_scent")    : out = ba::follow_scent;    return true;
+    case djb2_hash_32c("follow_noise")    : out = ba::follow_noise;    return true;
+    default                               : break;
+    }
+
+    return false;
+}
+
+} // namespace
+
+bool compile_behavior(
+    std::vector<std::string> const& rules
+  , behavior_program& out
+  , std::string& error
+) {
+    using op          = behavior_program::op;
+    using instruction = behavior_program::instruction;
+
+    std::vector<instruction> code;
+    int32_t sense_radius = 0;
+    bool    uses_player  = false;
+    bool    uses_scent   = false;
+    bool    uses_noise   = false;
+    bool    terminated   = false;
+
+    auto const fail = [&](size_t const rule, std::string const& what) {
+        error = "rule " + std::to_string(rule) + " (\"" + rules[rule] + "\"): " + what;
+        return false;
+    };
+
+    for (size_t r = 0; r < rules.size(); ++r) {
+        if (terminated) {
+            return fail(r, "unreachable; follows an unconditional rule");
+        }
+
+        auto const words = split_words(rules[r]);
+        auto const first = code.size();
+
+        size_t i = 0;
+
+        // conditions
+        for (; i < words.size() && words[i] != "->"; ++i) {
+            if (code.size() != first) {
+                if (words[i] != "&") {
+                    return fail(r, "expected \"&\" or \"->\"; got \"" + words[i] + "\"");
+                } else if (++i == words.size()) {
+                    break;
+                }
+            }
+
+            instruction c {op::chance, behavior_action::wait, 0, 0};
+
+            if (!to_condition(words[i], c.code)) {
+                return fail(r, "unknown condition \"" + words[i] + "\"");
+            }
+
+            if (i + 1 == words.size() || !parse_number(words[++i], c.arg)) {
+                return fail(r, "expected a number");
+            }
+
+            switch (c.code) {
+            case op::player_within: BK_ATTRIBUTE_FALLTHROUGH;
+            case op::player_beyond:
+                uses_player = true;
+                break;
+            case op::other_within:  BK_ATTRIBUTE_FALLTHROUGH;
+            case op::other_beyond:
+                sense_radius = std::max(sense_radius, c.arg);
+                break;
+            case op::scent_above:
+                uses_scent = true;
+                break;
+            case op::noise_above:
+                uses_noise = true;
+                break;
+            case op::chance: BK_ATTRIBUTE_FALLTHROUGH;
+            case op::act:    BK_ATTRIBUTE_FALLTHROUGH;
+            default:
+                break;
+            }
+
+            code.push_back(c);
+        }
+
+        if (i == words.size()) {
+            return fail(r, "expected \"->\"");
+        }
+
+        // action
+        instruction a {op::act, behavior_action::wait, 0, 1};
+
+        if (++i == words.size() || !to_action(words[i], a.action)) {
+            return fail(r, "expected an action");
+        }
+
+        if (++i < words.size()) {
+            if (!parse_number(words[i], a.arg) || a.arg < 1) {
+                return fail(r, "expected a number of turns > 0");
+            }
+            ++i;
+        }
+
+        if (i != words.size()) {
+            return fail(r, "unexpected \"" + words[i] + "\"");
+        }
+
+        terminated = (code.size() == first);
+        code.push_back(a);
+
+        if (code.size() > std::numeric_limits<uint16_t>::max()) {
+            return fail(r, "too many rules");
+        }
+
+        // failed conditions fall through to the next rule
+        for (auto j = first; j + 1 < code.size(); ++j) {
+            code[j].fail = static_cast<uint16_t>(code.size());
+        }
+    }
+
+    if (!terminated) {
+        code.push_back({op::act, behavior_action::wait, 0, 1});
+    }
+
+    out.code_         = std::move(code);
+    out.sense_radius_ = sense_radius;
+    out.uses_player_  = uses_player;
+    out.uses_scent_   = uses_scent;
+    out.uses_noise_   = uses_noise;
+
+    return true;
+}
+
+} //namespace boken
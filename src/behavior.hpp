@@ -0,0 +1,114 @@
+#pragma once
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace boken { class random_state; }
+
+namespace boken {
+
+//! The actions a behavior can decide upon.
+enum class behavior_action : uint8_t {
+    wait            //!< do nothing
+  , wander          //!< move in a random direction
+  , approach_player //!< move one step toward the player
+  , flee_player     //!< move one step away from the player
+  , approach_other  //!< move one step toward the nearest other entity
+  , follow_scent    //!< move one step up the gradient of the scent field
+  , follow_noise    //!< move one step up the gradient of the noise field
+};
+
+//! The facts about an entity's surroundings a behavior decides upon. Distances
+//! are Chebyshev distances, or none if there is no such thing within range.
+//! Field values are in hundredths.
+struct behavior_inputs {
+    static constexpr int32_t none = std::numeric_limits<int32_t>::max();
+
+    int32_t player_distance = none;
+    int32_t other_distance  = none;
+    int32_t scent           = 0;
+    int32_t noise           = 0;
+};
+
+struct behavior_decision {
+    behavior_action action;
+    int32_t         turns; //!< the mean number of turns until the next decision
+};
+
+//! A behavior compiled from a list of rules (see compile_behavior) into a flat
+//! list of instructions.
+//!
+//! Each condition of a rule is a single instruction holding the index of the
+//! first instruction of the next rule to jump to if the condition fails; each
+//! rule ends with an instruction holding the action. The last rule is always
+//! unconditional, so run() never falls off the end.
+class behavior_program {
+    friend bool compile_behavior(std::vector<std::string> const& rules
+                               , behavior_program& out
+                               , std::string& error);
+public:
+    enum class op : uint8_t {
+        chance, player_within, player_beyond, other_within, other_beyond
+      , scent_above, noise_above
+      , act
+    };
+
+    struct instruction {
+        op              code;
+        behavior_action action; //!< for op::act only
+        uint16_t        fail;   //!< the next instruction if a test fails
+        int32_t         arg;
+    };
+
+    static_assert(sizeof(instruction) == 8, "");
+
+    //! Evaluate the rules in order and return the action of the first whose
+    //! conditions all hold.
+    //! @pre The program is not empty.
+    behavior_decision run(behavior_inputs const& in, random_state& rng) const noexcept;
+
+    //! The number of instructions; 0 if the program is empty.
+    size_t size() const noexcept { return code_.size(); }
+
+    //! Whether any rule depends on the distance to the player.
+    bool uses_player() const noexcept { return uses_player_; }
+
+    //! Whether any rule depends on the value of the scent / noise fields.
+    //!@{
+    bool uses_scent() const noexcept { return uses_scent_; }
+    bool uses_noise() const noexcept { return uses_noise_; }
+    //!@}
+
+    //! The greatest distance to another entity any rule depends on; 0 if none.
+    //! Other entities further away than this don't need to be looked for.
+    int32_t sense_radius() const noexcept { return sense_radius_; }
+private:
+    std::vector<instruction> code_;
+    int32_t sense_radius_ {0};
+    bool    uses_player_  {false};
+    bool    uses_scent_   {false};
+    bool    uses_noise_   {false};
+};
+
+//! Compile a behavior from @p rules, each of the form
+//!   [condition {& condition}] -> action [turns]
+//! where a condition is one of
+//!   chance N, player_within N, player_beyond N, other_within N, other_beyond N,
+//!   scent_above N, noise_above N
+//! and action is one of
+//!   wait, wander, approach_player, flee_player, approach_other, follow_scent,
+//!   follow_noise
+//! The optional turns, by default 1, is the mean number of turns until the
+//! entity decides again. If the last rule isn't unconditional, "-> wait" is
+//! implied.
+//! @returns true on success; otherwise false with a description of the problem
+//!          in @p error, and @p out unmodified.
+bool compile_behavior(std::vector<std::string> const& rules
+                    , behavior_program& out
+                    , std::string& error);
+
+} //namespace boken
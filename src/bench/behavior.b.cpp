@@ -0,0 +1,142 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "behavior.hpp"
+#include "data.hpp"
+#include "entity.hpp"
+#include "hash.hpp"
+#include "level.hpp"
+#include "random.hpp"
+#include "world.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+TEST_CASE("behavior_program run", "[benchmark]") {
+    using namespace boken;
+
+    constexpr int n = 10000000;
+
+    auto const rng = make_random_state();
+
+    behavior_program p;
+    std::string      error;
+
+    REQUIRE(compile_behavior({
+        "player_within 1 -> wait"
+      , "player_within 2 & chance 50 -> flee_player"
+      , "player_within 8 & other_beyond 3 -> approach_player 2"
+      , "other_within 5 & chance 50 -> approach_other 10"
+      , "chance 10 -> wait 20"
+      , "-> wander 10"
+    }, p, error));
+
+    // a spread of situations so that every rule is reached
+    std::vector<behavior_inputs> inputs(4096);
+    for (auto& in : inputs) {
+        in.player_distance = random_chance_in_x(*rng, 1, 4)
+          ? behavior_inputs::none : random_uniform_int(*rng, 0, 20);
+        in.other_distance  = random_chance_in_x(*rng, 1, 2)
+          ? behavior_inputs::none : random_uniform_int(*rng, 1, 5);
+    }
+
+    int32_t counts[5] {};
+
+    auto const t = bench::time([&] {
+        for (int i = 0; i < n; ++i) {
+            auto const d = p.run(inputs[static_cast<size_t>(i) % inputs.size()], *rng);
+            ++counts[static_cast<size_t>(d.action)];
+        }
+    });
+
+    bench::report("behavior", t, "%d decisions (%.1f M / s); wait %d, wander %d"
+                                 ", approach player %d, flee %d, approach other %d"
+      , n, n / t.count() / 1.0e3, counts[0], counts[1], counts[2], counts[3], counts[4]);
+}
+
+TEST_CASE("behavior_program sensing", "[benchmark]") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    auto const lvl = make_level(*rng, *w, sizei32x {160}, sizei32y {120}, 0);
+
+    auto const def = db->find(make_id<entity_id>("rat_small"));
+    REQUIRE(!!def);
+
+    // an entity on every tile where one can be placed
+    std::vector<point2i32> entities;
+    for (auto y = 0; y < 120; ++y) {
+        for (auto x = 0; x < 160; ++x) {
+            auto const p = point2i32 {x, y};
+            if (lvl->can_place_entity_at(p) == placement_result::ok) {
+                lvl->add_object_at(create_object(*db, *w, *def, *rng), p);
+                entities.push_back(p);
+            }
+        }
+    }
+
+    behavior_program p;
+    std::string      error;
+
+    REQUIRE(compile_behavior({
+        "other_within 5 & chance 50 -> approach_other 10"
+      , "-> wander 10"
+    }, p, error));
+
+    REQUIRE(p.sense_radius() > 0);
+
+    auto const distance = [](point2i32 const a, point2i32 const b) noexcept {
+        auto const v = b - a;
+        return std::max(std::abs(value_cast(v.x)), std::abs(value_cast(v.y)));
+    };
+
+    // one turn in which every entity senses those near it and decides, the
+    // same way as the game does
+    auto const tick = [&](auto&& for_each_near) {
+        int32_t approached = 0;
+
+        auto const t = bench::time([&] {
+            for (auto const from : entities) {
+                behavior_inputs in;
+
+                for_each_near(from, [&](point2i32 const q) {
+                    auto const d = distance(from, q);
+                    if (q != from && d < in.other_distance) {
+                        in.other_distance = d;
+                    }
+                });
+
+                auto const d = p.run(in, *rng);
+                approached += d.action == behavior_action::approach_other ? 1 : 0;
+            }
+        });
+
+        return std::make_pair(t, approached);
+    };
+
+    auto const near = tick([&](point2i32 const from, auto&& f) {
+        lvl->for_each_entity_near(from, p.sense_radius()
+          , [&](level::entity_position const e) { f(e.first); });
+    });
+
+    auto const r = p.sense_radius();
+    auto const scan = tick([&](point2i32 const from, auto&& f) {
+        lvl->for_each_entity([&](entity_instance_id, point2i32 const q) {
+            if (distance(from, q) <= r) {
+                f(q);
+            }
+        });
+    });
+
+    bench::report("behavior sensing", near.first
+      , "%zu entities by for_each_entity_near (%d approached)"
+      , entities.size(), near.second);
+    bench::report("behavior sensing", scan.first
+      , "%zu entities by a scan of every entity (%d approached)"
+      , entities.size(), scan.second);
+}
@@ -0,0 +1,25 @@
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace boken { namespace bench {
+
+void report(char const* const name, duration_t const t, char const* const fmt, ...) noexcept {
+    va_list args;
+    va_start(args, fmt);
+
+    printf("%-18s %10.3f ms : ", name, t.count());
+    vprintf(fmt, args);
+    printf("\n");
+
+    va_end(args);
+}
+
+}} // namespace boken::bench
+
+int main(int const argc, char const* const argv[]) {
+    return Catch::Session().run(argc, argv);
+}
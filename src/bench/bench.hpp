@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+
+//
+// Benchmarks are built into their own executable, boken_bench, rather than
+// the unit tests run at startup; they are Catch test cases tagged [benchmark]
+// that time their work with bench::time and print each result with
+// bench::report.
+//
+
+namespace boken { namespace bench {
+
+using clock_t    = std::chrono::high_resolution_clock;
+using duration_t = std::chrono::duration<double, std::milli>;
+
+//! The time taken to call f().
+template <typename F>
+duration_t time(F&& f) {
+    auto const t0 = clock_t::now();
+    f();
+    return clock_t::now() - t0;
+}
+
+#ifndef _MSC_VER
+#   define BK_PRINTF_ATTRIBUTE __attribute__ ((__format__(__printf__, 3, 4)))
+#else
+#   define BK_PRINTF_ATTRIBUTE
+#endif
+
+//! Print one line of results for the benchmark @p name: the time @p t, and
+//! what was measured as given by the printf style @p fmt.
+void report(char const* name, duration_t t, char const* fmt, ...) noexcept BK_PRINTF_ATTRIBUTE;
+
+#undef BK_PRINTF_ATTRIBUTE
+
+}} // namespace boken::bench
@@ -0,0 +1,42 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "diffusion.hpp"
+#include "random.hpp"
+
+TEST_CASE("diffusion_field update", "[benchmark]") {
+    using namespace boken;
+
+    auto const w = sizei32x {1024};
+    auto const h = sizei32y {1024};
+
+    constexpr int steps = 100;
+
+    auto const rng = make_random_state();
+
+    // one in five tiles is solid
+    diffusion_field mask {w, h};
+    for (auto y = 0; y < value_cast(h); ++y) {
+        for (auto x = 0; x < value_cast(w); ++x) {
+            mask.set(point2i32 {x, y}, random_chance_in_x(*rng, 1, 5) ? 0.0f : 1.0f);
+        }
+    }
+
+    diffusion_field f {w, h};
+    for (int i = 0; i < 1000; ++i) {
+        f.add(point2i32 {random_uniform_int(*rng, 0, 1023)
+                       , random_uniform_int(*rng, 0, 1023)}, 1.0f);
+    }
+
+    auto const t = bench::time([&] {
+        for (int i = 0; i < steps; ++i) {
+            f.update(mask, 0.2f, 0.98f);
+        }
+    });
+
+    auto const megatiles = value_cast(w) * value_cast(h) / (1024.0 * 1024.0);
+
+    bench::report("diffusion", t, "%d steps of %dx%d; %.3f ms per megatile step (total %f)"
+      , steps, value_cast(w), value_cast(h), t.count() / steps / megatiles
+      , static_cast<double>(f.total()));
+}
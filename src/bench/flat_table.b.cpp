@@ -0,0 +1,41 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "data.hpp"
+#include "item_def.hpp"
+#include "hash.hpp"
+
+#include <vector>
+
+TEST_CASE("game_database find(item_id)", "[benchmark]") {
+    using namespace boken;
+
+    auto const db = make_game_database();
+
+    // a mix of existing and missing ids
+    std::vector<item_id> const ids {
+        make_id<item_id>("coin")
+      , make_id<item_id>("pile")
+      , make_id<item_id>("container_chest")
+      , make_id<item_id>("weapon_dagger")
+      , make_id<item_id>("potion_health_small")
+      , make_id<item_id>("no_such_item")
+    };
+
+    constexpr int iterations = 1000000;
+
+    size_t found = 0;
+    auto const t = bench::time([&] {
+        for (int i = 0; i < iterations; ++i) {
+            for (auto const id : ids) {
+                found += db->find(id) ? 1u : 0u;
+            }
+        }
+    });
+
+    auto const n = static_cast<double>(iterations)
+                 * static_cast<double>(ids.size());
+
+    bench::report("find(item_id)", t, "%.2f ns / lookup (%zu found)"
+      , t.count() * 1.0e6 / n, found);
+}
@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "graph.hpp"
+#include "test/graph.t.hpp"
+
+#include "random.hpp"
+
+#include <vector>
+
+TEST_CASE("d_star_lite_pather", "[benchmark]") {
+    using namespace boken;
+
+    constexpr int32_t size = 256;
+
+    auto const rng = make_random_state();
+
+    // one in five tiles is blocked, except along the edges
+    mask_graph graph {size, size};
+    for (auto y = 1; y < size - 1; ++y) {
+        for (auto x = 1; x < size - 1; ++x) {
+            graph.set_blocked({x, y}, random_chance_in_x(*rng, 1, 5));
+        }
+    }
+
+    auto const start = point2i32 {0, 0};
+    auto const goal  = point2i32 {size - 1, size - 1};
+
+    auto pather = make_d_star_lite_pather(graph, diagonal_heuristic());
+    REQUIRE(pather.plan(graph, start, goal));
+
+    // walk to the goal; every few steps the tile two steps ahead is blocked
+    // and the path repaired, compared with a new search from scratch
+    std::vector<point2i32> path;
+    pather.copy_path(graph, back_inserter(path));
+
+    bench::duration_t t_repair {};
+    bench::duration_t t_search {};
+    int repairs = 0;
+    int steps   = 0;
+
+    for (size_t i = 0; path.size() > 3 && steps < 10000; ++steps) {
+        auto const p = path[1];
+        pather.move_to(p);
+
+        if (++i % 4 == 0 && path[3] != goal) {
+            graph.set_blocked(path[3], true);
+
+            bool ok = false;
+            t_repair += bench::time([&] {
+                pather.update(graph, path[3]);
+                ok = pather.replan(graph);
+            });
+
+            std::vector<point2i32> expected;
+            t_search += bench::time([&] {
+                expected = a_star_path(graph, p, goal);
+            });
+
+            REQUIRE(ok == !expected.empty());
+            if (!ok) {
+                break;
+            }
+
+            path.clear();
+            pather.copy_path(graph, back_inserter(path));
+            REQUIRE(path.size() == expected.size());
+
+            ++repairs;
+        }
+
+        path.clear();
+        pather.copy_path(graph, back_inserter(path));
+        REQUIRE(path.front() == p);
+        REQUIRE(is_valid_path(graph, path));
+    }
+
+    bench::report("d_star_lite", t_repair, "%d steps, %d repairs by update and replan"
+      , steps, repairs);
+    bench::report("a_star", t_search, "%d searches from scratch", repairs);
+}
@@ -0,0 +1,45 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "item.hpp"
+#include "item_pile.hpp"
+#include "item_properties.hpp"
+#include "data.hpp"
+#include "world.hpp"
+#include "random.hpp"
+#include "context.hpp"
+#include "hash.hpp"
+
+TEST_CASE("merge_into_pile", "[benchmark]") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    context ctx {*w, *db};
+
+    auto const potion = db->find(make_id<item_id>("potion_health_small"));
+    REQUIRE(!!potion);
+
+    constexpr int n = 10000;
+
+    item_pile pile {w->get_item_deleter()};
+
+    auto const t = bench::time([&] {
+        for (int i = 0; i < n; ++i) {
+            auto itm = create_object(*db, *w, *potion, *rng);
+            auto const d = item_descriptor {ctx, itm.get()};
+            merge_into_pile(ctx, std::move(itm), d, pile);
+        }
+    });
+
+    uint32_t total = 0;
+    for (auto const id : pile) {
+        total += current_stack_size(const_item_descriptor {const_context {ctx}, id});
+    }
+
+    REQUIRE(total == n);
+
+    bench::report("merge_into_pile", t, "x %d (%zu stacks)", n, pile.size());
+}
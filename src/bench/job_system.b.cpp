@@ -0,0 +1,41 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cmath>
+
+TEST_CASE("job_system", "[benchmark]") {
+    using namespace boken;
+
+    constexpr size_t n = 1 << 22;
+
+    std::vector<double> out(n);
+    auto const work = [&](size_t const first, size_t const last) {
+        for (auto i = first; i < last; ++i) {
+            auto const x = static_cast<double>(i);
+            out[i] = std::sqrt(x) * std::sin(x) + std::cos(x);
+        }
+    };
+
+    auto const serial = bench::time([&] { work(0, n); });
+    bench::report("serial", serial, "%zu items", n);
+
+    auto const hw = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threads = 1; threads <= hw; threads *= 2) {
+        auto const jobs = make_job_system(threads);
+
+        auto const t = bench::time([&] {
+            parallel_for(*jobs, n, 1 << 12, work);
+        });
+
+        auto const stats = jobs->stats();
+        bench::report("parallel_for", t, "%zu workers (x%.2f, %llu jobs, %llu stolen)"
+          , threads, serial / t
+          , static_cast<unsigned long long>(stats.executed)
+          , static_cast<unsigned long long>(stats.stolen));
+    }
+}
@@ -0,0 +1,51 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "scheduler.hpp"
+#include "random.hpp"
+
+TEST_CASE("actor_scheduler", "[benchmark]") {
+    using namespace boken;
+
+    constexpr int n     = 10000;
+    constexpr int turns = 1000;
+
+    auto const rng = make_random_state();
+
+    // every actor rolls every turn and acts 1 in 10 times
+    {
+        long long acted = 0;
+
+        auto const t = bench::time([&] {
+            for (int turn = 0; turn < turns; ++turn) {
+                for (int i = 0; i < n; ++i) {
+                    if (!random_chance_in_x(*rng, 9, 10)) {
+                        ++acted;
+                    }
+                }
+            }
+        });
+
+        bench::report("touch all", t, "%d actors x %d turns (%.1f acted / turn)"
+          , n, turns, static_cast<double>(acted) / turns);
+    }
+
+    // actors only wake when they act; on average once every 10 turns
+    {
+        actor_scheduler<int> s;
+        for (int i = 0; i < n; ++i) {
+            s.schedule(i, static_cast<uint64_t>(random_uniform_int(*rng, 0, 9)));
+        }
+
+        auto const t = bench::time([&] {
+            for (int turn = 0; turn < turns; ++turn) {
+                s.advance(1, [&](int) {
+                    return static_cast<uint64_t>(random_uniform_int(*rng, 1, 19));
+                });
+            }
+        });
+
+        bench::report("scheduled", t, "%d actors x %d turns (%.1f activated / turn)"
+          , n, turns, static_cast<double>(s.stats().total_activated) / turns);
+    }
+}
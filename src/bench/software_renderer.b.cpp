@@ -0,0 +1,41 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "software_renderer.hpp"
+#include "test/software_renderer.t.hpp"
+
+TEST_CASE("software_renderer map", "[benchmark]") {
+    using namespace boken;
+
+    constexpr int frames = 100;
+
+    headless_map m {sizei32x {1280}, sizei32y {720}};
+
+    view v;
+    v.x_off = -100.0f;
+    v.y_off = -37.0f;
+
+    auto const time_frames = [&](bool const targets) {
+        m.r->enable_targets(targets);
+        m.render(v);
+
+        return bench::time([&] {
+            for (int i = 0; i < frames; ++i) {
+                m.render(v);
+            }
+        }) / frames;
+    };
+
+    auto const direct = time_frames(false);
+    auto const cached = time_frames(true);
+
+    m.r->enable_targets(false);
+    m.render(v);
+    auto const changes = m.r->stats().state_changes;
+
+    bench::report("software_renderer", direct
+      , "1280x720 map frame a tile at a time; %u changes of texture or color mod"
+      , changes);
+    bench::report("software_renderer", cached
+      , "1280x720 map frame from cached chunks");
+}
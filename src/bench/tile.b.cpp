@@ -0,0 +1,47 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "tile.hpp"
+
+#include <vector>
+
+TEST_CASE("tile_map tex_coord", "[benchmark]") {
+    using namespace boken;
+
+    tile_map tmap {tile_map_type::entity, 0
+      , sizei32x {18}, sizei32y {18}, sizei32x {26}, sizei32y {17}};
+
+    std::vector<entity_id> ids;
+    for (uint32_t i = 0; i < 200; ++i) {
+        ids.push_back(entity_id {djb2_hash_32c("entity") + i * 7919u});
+        tmap.add_mapping(ids.back(), i);
+    }
+
+    constexpr int n = 1000000;
+
+    auto const time = [&](auto f) {
+        int32_t sum = 0;
+
+        auto const t = bench::time([&] {
+            for (int i = 0; i < n; ++i) {
+                auto const p = f(ids[static_cast<size_t>(i) % ids.size()]);
+                sum += value_cast(p.x) + value_cast(p.y);
+            }
+        });
+
+        return std::make_pair(t, sum);
+    };
+
+    // the coordinates as they were found before tile_map::tex_coord
+    auto const slow = time([&](entity_id const id) {
+        return underlying_cast_unsafe<int16_t>(
+            tmap.index_to_rect(id_to_index(tmap, id)).top_left());
+    });
+
+    auto const fast = time([&](entity_id const id) { return tmap.tex_coord(id); });
+
+    REQUIRE(slow.second == fast.second);
+
+    bench::report("tile_map", slow.first, "%d lookups by find and index_to_rect", n);
+    bench::report("tile_map", fast.first, "%d lookups by tex_coord", n);
+}
@@ -0,0 +1,47 @@
+#include "catch.hpp"
+#include "bench.hpp"
+
+#include "world.hpp"
+#include "data.hpp"
+#include "item.hpp"
+#include "item_def.hpp"
+#include "random.hpp"
+#include "hash.hpp"
+
+#include <vector>
+
+TEST_CASE("world create_objects", "[benchmark]") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const rng = make_random_state();
+
+    auto const def = db->find(make_id<item_id>("coin"));
+    REQUIRE(!!def);
+
+    constexpr size_t n = 100000;
+
+    {
+        auto const w = make_world();
+        std::vector<unique_item> items;
+
+        auto const t = bench::time([&] {
+            for (size_t i = 0; i < n; ++i) {
+                items.push_back(create_object(*db, *w, *def, *rng));
+            }
+        });
+
+        bench::report("create_object", t, "x %zu", n);
+    }
+
+    {
+        auto const w = make_world();
+        std::vector<unique_item> items;
+
+        auto const t = bench::time([&] {
+            create_objects(*db, *w, *def, *rng, n, items);
+        });
+
+        bench::report("create_objects", t, "x %zu", n);
+    }
+}
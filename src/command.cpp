@@ -135,6 +135,9 @@ void command_translator_impl::translate(kb_event const event, kb_modifiers const
     case kb_scancode::k_f1:
         handler_(command_type::debug_toggle_regions, 0);
         break;
+    case kb_scancode::k_f2:
+        handler_(command_type::debug_toggle_batching, 0);
+        break;
     default:
         break;
     }
@@ -191,6 +194,7 @@ command_type string_to_enum(string_view const str) noexcept {
         BK_ENUM_MAPPING(toggle_show_equipment);
         BK_ENUM_MAPPING(debug_toggle_regions);
         BK_ENUM_MAPPING(debug_teleport_self);
+        BK_ENUM_MAPPING(debug_toggle_batching);
         default:
             break;
     }
@@ -242,6 +246,7 @@ string_view enum_to_string(command_type const id) noexcept {
         BK_ENUM_MAPPING(toggle_show_equipment);
         BK_ENUM_MAPPING(debug_toggle_regions);
         BK_ENUM_MAPPING(debug_teleport_self);
+        BK_ENUM_MAPPING(debug_toggle_batching);
         default:
             break;
     }
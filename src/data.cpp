@@ -1,14 +1,17 @@
 #include "data.hpp"
+#include "behavior.hpp"
 #include "entity_def.hpp"
 #include "item_def.hpp"
 #include "tile.hpp"
 #include "serialize.hpp"
 #include "algorithm.hpp"
 #include "context_fwd.hpp"
+#include "flat_table.hpp"
 
 #include "bkassert/assert.hpp"
 
-#include <unordered_map>
+#include <memory>
+#include <vector>
 #include <cstdio>
 
 namespace boken {
@@ -20,11 +23,15 @@ public:
     game_database_impl();
 
     item_definition const* find(item_id const id) const noexcept final override {
-        return find_or_nullptr(item_defs_, id);
+        return item_defs_.find(id);
     }
 
     entity_definition const* find(entity_id const id) const noexcept final override {
-        return find_or_nullptr(entity_defs_, id);
+        return entity_defs_.find(id);
+    }
+
+    behavior_program const* find(behavior_id const id) const noexcept final override {
+        return behaviors_.find(id);
     }
 
     string_view find(item_property_id const id) const noexcept final override {
@@ -39,17 +46,26 @@ public:
 private:
     template <typename Id, typename Container>
     string_view find_(Container const& c, Id const id) const noexcept {
-        auto const it = c.find(id);
-        return it != end(c)
-          ? string_view {it->second.name}
+        auto const ptr = c.find(id);
+        return ptr
+          ? string_view {ptr->name}
           : string_view {"{none such}"};
     }
 
     void load_entity_defs_();
     void load_item_defs_();
+    void load_behavior_defs_();
+
+    //! Sort the loaded tables; after this no new data can be added.
+    void freeze_();
+
+    //! Find or create the body plan matching the body_n / body_x properties of
+    //! @p def.
+    body_plan const* intern_body_plan_(entity_definition const& def);
 
-    std::unordered_map<entity_id, entity_definition, identity_hash> entity_defs_;
-    std::unordered_map<item_id,   item_definition,   identity_hash> item_defs_;
+    flat_table<entity_id, entity_definition> entity_defs_;
+    flat_table<item_id,   item_definition>   item_defs_;
+    flat_table<behavior_id, behavior_program> behaviors_;
 
     struct property_data {
         serialize_data_type type;
@@ -57,8 +73,10 @@ private:
         int32_t             count;
     };
 
-    std::unordered_map<entity_property_id, property_data, identity_hash> entity_properties_;
-    std::unordered_map<item_property_id,   property_data, identity_hash> item_properties_;
+    flat_table<entity_property_id, property_data> entity_properties_;
+    flat_table<item_property_id,   property_data> item_properties_;
+
+    std::vector<std::unique_ptr<body_plan>> body_plans_;
 
     tile_map tile_map_base_     {tile_map_type::base,   0, sizei32x {18}, sizei32y {18}, sizei32x {16}, sizei32y {16}};
     tile_map tile_map_entities_ {tile_map_type::entity, 1, sizei32x {18}, sizei32y {18}, sizei32x {26}, sizei32y {17}};
@@ -85,21 +103,22 @@ namespace {
 
 template <typename Container>
 auto load_definition_(Container& c, tile_map& tmap) {
-    using def_t = typename std::decay_t<Container>::mapped_type;
+    using def_t = typename std::decay_t<Container>::value_type;
 
     return [&](def_t const& def) {
         auto const tile_index =
             def.properties.value_or(djb2_hash_32c("tile_index"), 0);
 
-        auto const result = c.emplace(def.id, std::move(def));
-        if (!result.second) {
-            BK_ASSERT(false); //TODO collision
-        }
-
         tmap.add_mapping(def.id, tile_index);
+
+        auto result = def;
+        result.update_slots();
+        c.insert(def.id, std::move(result));
     };
 }
 
+//! Each use of a property is staged separately; uses of the same property are
+//! merged when the table is frozen.
 template <typename Container>
 auto load_property_(Container& c) {
     return [&](string_view         const string
@@ -108,30 +127,51 @@ auto load_property_(Container& c) {
              , uint32_t            const //value //TODO
         ) {
             using id_t  = typename std::decay_t<Container>::key_type;
-            using map_t = typename std::decay_t<Container>::mapped_type;
+            using map_t = typename std::decay_t<Container>::value_type;
 
-            auto const id = id_t {hash};
-            auto const it = c.find(id);
+            c.insert(id_t {hash}, map_t {type, string.to_string(), 1});
 
-            if (it == end(c)) {
-                c.emplace(id, map_t {type, string.to_string(), 1});
-                return true;
-            }
+            return true;
+        };
+}
+
+template <typename Container>
+void freeze_definitions_(Container& c, char const* const what) {
+    using def_t = typename std::decay_t<Container>::value_type;
+
+    auto const collisions = c.freeze(
+        [what](def_t const& kept, def_t const& dup) {
+            printf("error: %s id collision between \"%s\" and \"%s\"\n"
+                 , what, kept.id_string.c_str(), dup.id_string.c_str());
+            return false;
+        });
+
+    BK_ASSERT(collisions == 0);
+}
 
-            if (it->second.name != string) {
-                BK_ASSERT(false); //TODO collision
+template <typename Container>
+void freeze_properties_(Container& c, char const* const what) {
+    using map_t = typename std::decay_t<Container>::value_type;
+
+    auto const collisions = c.freeze(
+        [what](map_t& kept, map_t const& dup) {
+            if (kept.name != dup.name) {
+                printf("error: %s property collision between \"%s\" and \"%s\"\n"
+                     , what, kept.name.c_str(), dup.name.c_str());
+                return false;
             }
 
-            if (it->second.type != type) {
+            if (kept.type != dup.type) {
                 //TODO type differs between property usages
                 printf("warning type differs for property \"%s\"\n"
-                     , string.data());
+                     , kept.name.c_str());
             }
 
-            ++it->second.count;
-
+            kept.count += dup.count;
             return true;
-        };
+        });
+
+    BK_ASSERT(collisions == 0);
 }
 
 } // namespace
@@ -146,9 +186,95 @@ void game_database_impl::load_item_defs_() {
                         , load_property_(item_properties_));
 }
 
+void game_database_impl::load_behavior_defs_() {
+    load_behavior_definitions([&](string_view const id, auto const& rules) {
+        behavior_program program;
+        std::string      error;
+
+        if (!compile_behavior(rules, program, error)) {
+            printf("error: behavior \"%s\" %s\n"
+                 , id.to_string().c_str(), error.c_str());
+            BK_ASSERT(false);
+            return;
+        }
+
+        behaviors_.insert(behavior_id {djb2_hash_32(id.begin(), id.end())}
+                        , std::move(program));
+    });
+}
+
+body_plan const*
+game_database_impl::intern_body_plan_(entity_definition const& def) {
+    auto const n = def.properties.value_or(
+        entity_property_id {djb2_hash_32c("body_n")}, 0);
+
+    if (n <= 0) {
+        return nullptr;
+    }
+
+    BK_ASSERT(n <= body_plan::max_parts);
+
+    body_plan plan;
+    plan.parts.reserve(n);
+
+    char key[] = "body_\0\0";
+    for (uint32_t i = 0; i < n && i < body_plan::max_parts; ++i) {
+        if (n <= 9) {
+            *(std::end(key) - 3) = static_cast<char>('0' + i);
+        } else {
+            *(std::end(key) - 2) = static_cast<char>('0' + i / 10);
+            *(std::end(key) - 3) = static_cast<char>('0' + i % 10);
+        }
+
+        auto const id = def.properties.value_or(
+            entity_property_id {djb2_hash_32(key)}, 0);
+
+        BK_ASSERT(id != 0);
+
+        plan.parts.push_back(body_part_id {id});
+    }
+
+    auto const it = std::find_if(begin(body_plans_), end(body_plans_)
+      , [&](auto const& p) { return p->parts == plan.parts; });
+
+    if (it != end(body_plans_)) {
+        return it->get();
+    }
+
+    body_plans_.push_back(std::make_unique<body_plan>(std::move(plan)));
+    return body_plans_.back().get();
+}
+
+void game_database_impl::freeze_() {
+    freeze_definitions_(entity_defs_, "entity");
+    freeze_definitions_(item_defs_,   "item");
+
+    if (behaviors_.freeze() != 0) {
+        printf("error: behavior id collision\n");
+        BK_ASSERT(false);
+    }
+    freeze_properties_(entity_properties_, "entity");
+    freeze_properties_(item_properties_,   "item");
+
+    for (auto& def : entity_defs_) {
+        def.body = intern_body_plan_(def);
+
+        auto const ai_type = def.slots.value_or(property_slot::ai_type
+                                              , djb2_hash_32c("default"));
+
+        def.behavior = behaviors_.find(behavior_id {ai_type});
+        if (!def.behavior) {
+            printf("warning: unknown ai_type for \"%s\"\n", def.id_string.c_str());
+            def.behavior = behaviors_.find(behavior_id {djb2_hash_32c("default")});
+        }
+    }
+}
+
 game_database_impl::game_database_impl() {
     load_entity_defs_();
     load_item_defs_();
+    load_behavior_defs_();
+    freeze_();
 }
 
 item_definition const* find(game_database const& db, item_id const id) noexcept {
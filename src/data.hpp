@@ -8,6 +8,7 @@
 namespace boken { struct item_definition; }
 namespace boken { struct entity_definition; }
 namespace boken { class tile_map; }
+namespace boken { class behavior_program; }
 namespace boken { enum class tile_map_type : uint32_t; }
 
 namespace boken {
@@ -22,6 +23,8 @@ public:
     virtual item_definition const* find(item_id id) const noexcept = 0;
     virtual entity_definition const* find(entity_id id) const noexcept = 0;
 
+    virtual behavior_program const* find(behavior_id id) const noexcept = 0;
+
     virtual string_view find(item_property_id id) const noexcept = 0;
     virtual string_view find(entity_property_id id) const noexcept = 0;
 
@@ -3,6 +3,7 @@
 #include "config.hpp"
 #include "math_types.hpp"
 #include "property_set.hpp"
+#include "property_slots.hpp"
 
 #include <string>
 #include <utility>
@@ -27,10 +28,19 @@ struct basic_definition {
     {
     }
 
+    //! Rebuild the cached slot values from properties; must be called after
+    //! properties is modified.
+    void update_slots() noexcept {
+        slots.assign(properties);
+    }
+
     properties_t    properties {};
     definition_id_t id         {};
     std::string     name       {"{null}"};
     std::string     id_string  {"{null}"};
+
+    //! Dense copies of the properties which have a property_slot.
+    property_slot_values<PropertyValue> slots {};
 };
 
 } //namespace boken
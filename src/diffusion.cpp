@@ -0,0 +1,165 @@
+#include "diffusion.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define BK_DIFFUSION_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define BK_DIFFUSION_SSE2 0
+#endif
+
+namespace boken {
+
+namespace {
+
+//! Update the tiles [first, last) of one row; see diffusion_field::update.
+//! @param v The row of values; v - s and v + s are the rows above and below.
+//! @param m The same row of the passability mask.
+//! @param s The stride of both fields.
+void update_row(
+    float*       const out
+  , float const* const v
+  , float const* const m
+  , size_t       const s
+  , size_t       const first
+  , size_t       const last
+  , float        const rate
+  , float        const decay
+) noexcept {
+    float const* const vn = v - s;
+    float const* const vs = v + s;
+    float const* const mn = m - s;
+    float const* const ms = m + s;
+
+    size_t x = first;
+
+#if BK_DIFFUSION_SSE2
+    auto const r = _mm_set1_ps(rate);
+    auto const d = _mm_set1_ps(decay);
+
+    for (; x + 4u <= last; x += 4u) {
+        auto const c = _mm_loadu_ps(v + x);
+
+        auto const flow_n = _mm_mul_ps(_mm_loadu_ps(mn + x)
+                                     , _mm_sub_ps(_mm_loadu_ps(vn + x), c));
+        auto const flow_s = _mm_mul_ps(_mm_loadu_ps(ms + x)
+                                     , _mm_sub_ps(_mm_loadu_ps(vs + x), c));
+        auto const flow_w = _mm_mul_ps(_mm_loadu_ps(m + x - 1u)
+                                     , _mm_sub_ps(_mm_loadu_ps(v + x - 1u), c));
+        auto const flow_e = _mm_mul_ps(_mm_loadu_ps(m + x + 1u)
+                                     , _mm_sub_ps(_mm_loadu_ps(v + x + 1u), c));
+
+        auto const flow = _mm_add_ps(
+            _mm_add_ps(_mm_add_ps(flow_n, flow_s), flow_w), flow_e);
+
+        _mm_storeu_ps(out + x, _mm_mul_ps(
+            _mm_mul_ps(_mm_loadu_ps(m + x), d)
+          , _mm_add_ps(c, _mm_mul_ps(r, flow))));
+    }
+#endif
+
+    for (; x < last; ++x) {
+        auto const c = v[x];
+        auto const flow = mn[x]     * (vn[x]     - c)
+                        + ms[x]     * (vs[x]     - c)
+                        + m[x - 1u] * (v[x - 1u] - c)
+                        + m[x + 1u] * (v[x + 1u] - c);
+
+        out[x] = m[x] * decay * (c + rate * flow);
+    }
+}
+
+} // namespace
+
+diffusion_field::diffusion_field(sizei32x const width, sizei32y const height)
+  : width_  {value_cast(width)}
+  , height_ {value_cast(height)}
+  , stride_ {static_cast<size_t>(value_cast(width)) + 2u}
+{
+    BK_ASSERT(width_ >= 0 && height_ >= 0);
+
+    auto const size = stride_ * (static_cast<size_t>(height_) + 2u);
+    values_.resize(size, 0.0f);
+    buffer_.resize(size, 0.0f);
+}
+
+size_t diffusion_field::index_(point2i32 const p) const noexcept {
+    auto const x = static_cast<size_t>(value_cast(p.x) + 1);
+    auto const y = static_cast<size_t>(value_cast(p.y) + 1);
+    return y * stride_ + x;
+}
+
+float diffusion_field::at(point2i32 const p) const noexcept {
+    auto const x = value_cast(p.x);
+    auto const y = value_cast(p.y);
+
+    return (x < 0 || y < 0 || x >= width_ || y >= height_)
+      ? 0.0f
+      : values_[index_(p)];
+}
+
+void diffusion_field::set(point2i32 const p, float const value) noexcept {
+    BK_ASSERT(value_cast(p.x) >= 0 && value_cast(p.x) < width_
+           && value_cast(p.y) >= 0 && value_cast(p.y) < height_);
+    values_[index_(p)] = value;
+}
+
+void diffusion_field::add(point2i32 const p, float const amount) noexcept {
+    BK_ASSERT(value_cast(p.x) >= 0 && value_cast(p.x) < width_
+           && value_cast(p.y) >= 0 && value_cast(p.y) < height_);
+    values_[index_(p)] += amount;
+}
+
+void diffusion_field::clear() noexcept {
+    std::fill(begin(values_), end(values_), 0.0f);
+}
+
+float diffusion_field::total() const noexcept {
+    return std::accumulate(begin(values_), end(values_), 0.0f);
+}
+
+vec2i32 diffusion_field::gradient(point2i32 const p) const noexcept {
+    auto best   = at(p);
+    auto result = vec2i32 {};
+
+    for (int32_t dy = -1; dy <= 1; ++dy) {
+        for (int32_t dx = -1; dx <= 1; ++dx) {
+            auto const v = vec2i32 {dx, dy};
+            auto const value = at(p + v);
+            if (value > best) {
+                best   = value;
+                result = v;
+            }
+        }
+    }
+
+    return result;
+}
+
+void diffusion_field::update(
+    diffusion_field const& passable
+  , float           const  rate
+  , float           const  decay
+) noexcept {
+    BK_ASSERT(passable.width_ == width_ && passable.height_ == height_);
+    BK_ASSERT(rate >= 0.0f && rate <= 0.25f && decay >= 0.0f && decay <= 1.0f);
+
+    auto const s = stride_;
+    auto const w = static_cast<size_t>(width_);
+
+    // the border is always 0 (and impassable), so x - 1 and x + 1 are always
+    // valid; solid tiles neither give nor receive anything.
+    for (size_t y = 1; y <= static_cast<size_t>(height_); ++y) {
+        auto const row = y * s;
+        update_row(buffer_.data() + row, values_.data() + row
+                 , passable.values_.data() + row, s, 1u, w + 1u, rate, decay);
+    }
+
+    values_.swap(buffer_);
+}
+
+} //namespace boken
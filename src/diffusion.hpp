@@ -0,0 +1,64 @@
+#pragma once
+
+#include "math_types.hpp"
+
+#include <vector>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace boken {
+
+//! A dense grid of scalar values, one per tile, which spreads out and fades
+//! over time; e.g. the scent of the player or the noise of a fight.
+//!
+//! The values are stored row by row with a border one tile wide which is
+//! always 0, so the stencil used by update() needs no bounds checks and its
+//! inner loop is a straight line over contiguous rows, 4 tiles at a time
+//! where SSE2 is available.
+class diffusion_field {
+public:
+    diffusion_field() = default;
+    diffusion_field(sizei32x width, sizei32y height);
+
+    sizei32x width()  const noexcept { return sizei32x {width_}; }
+    sizei32y height() const noexcept { return sizei32y {height_}; }
+
+    //! @returns The value at @p p; 0 for positions outside of the field.
+    float at(point2i32 p) const noexcept;
+
+    //! @pre @p p is within the field.
+    //!@{
+    void set(point2i32 p, float value) noexcept;
+    void add(point2i32 p, float amount) noexcept;
+    //!@}
+
+    void clear() noexcept;
+
+    //! The sum of every value.
+    float total() const noexcept;
+
+    //! The direction of the neighbor (of 8) of @p p with the greatest value
+    //! greater than that at @p p, or {0, 0} if there is none; i.e. the way to
+    //! go to follow the field toward its source.
+    vec2i32 gradient(point2i32 p) const noexcept;
+
+    //! Spread and fade the field by one step. Each tile exchanges @p rate of
+    //! the difference between its value and that of each of its 4 neighbors,
+    //! but only between tiles which are both passable; the result is then
+    //! scaled by @p decay. With a decay of 1 the total is preserved.
+    //! @param passable A field of the same size with 1 for passable tiles and
+    //!        0 for all others.
+    //! @pre 0 <= @p rate <= 1/4 (for stability) and 0 <= @p decay <= 1.
+    void update(diffusion_field const& passable, float rate, float decay) noexcept;
+private:
+    size_t index_(point2i32 p) const noexcept;
+
+    std::vector<float> values_;
+    std::vector<float> buffer_; //!< the destination of update()
+    int32_t width_  {0};
+    int32_t height_ {0};
+    size_t  stride_ {0};
+};
+
+} //namespace boken
@@ -14,6 +14,7 @@ enum class entity_property : uint32_t {
     is_player = djb2_hash_32c("is_player")
   , can_equip = djb2_hash_32c("can_equip")
   , body_n    = djb2_hash_32c("body_n")
+  , speed     = djb2_hash_32c("speed")
 };
 
 namespace {
@@ -118,6 +119,17 @@ bool can_equip(const_entity_descriptor const e) noexcept {
     return !!get_property_value_or(e, p_can_equip, 0);
 }
 
+entity_property_value speed_of(const_entity_descriptor const e) noexcept {
+    constexpr auto p_speed = property(entity_property::speed);
+    return get_property_value_or(e, p_speed, speed_normal);
+}
+
+int32_t action_ticks(const_entity_descriptor const e) noexcept {
+    auto const speed = std::max(speed_of(e), entity_property_value {1});
+    auto const ticks = (ticks_per_turn * speed_normal) / speed;
+    return std::max(static_cast<int32_t>(ticks), int32_t {1});
+}
+
 namespace {
 
 entity create_object(
@@ -251,10 +263,9 @@ bool impl_try_equip_item(
       : std::find_if(first, last, [&](body_part const& p) { return p.is_free(); });
 
     BK_ASSERT((it != last)
-           && (!part || std::addressof(*it) == part)
-           && it->is_free());
+           && (*it).is_free());
 
-    itm_dest->equip(it->id, get_instance(itm.obj));
+    itm_dest->equip((*it).id, get_instance(itm.obj));
 
     result.append("%s equip the %s to its %s."
       , name_of_decorated(ctx, subject).data()
@@ -293,8 +304,6 @@ bool impl_can_unequip_item(
           , [&](body_part const& p) { return p.equip == item_id; });
 
         BK_ASSERT(it != last);
-
-        part = std::addressof(*it);
     } else {
         BK_ASSERT(part->equip == get_instance(itm));
     }
@@ -331,8 +340,8 @@ bool impl_try_unequip_item(
 //                                  entity
 //=====--------------------------------------------------------------------=====
 entity::~entity() {
-    for (auto const& part : body_parts_) {
-        unique_item {part.equip, item_deleter_};
+    for (size_t i = 0; i < body_size_(); ++i) {
+        unique_item {equip_slots_[i], item_deleter_};
     }
 }
 
@@ -345,37 +354,36 @@ entity::entity(
 ) noexcept
   : object {deleter, instance, def.id}
   , item_deleter_ {deleter}
+  , body_plan_ {def.body}
   , max_health_ {1}
   , cur_health_ {1}
 {
-    auto const n = def.properties.value_or(
-        entity_property_id {djb2_hash_32c("body_n")}, 0);
-
-    if (n <= 0) {
-        return;
-    }
-
-    body_parts_.reserve(static_cast<size_t>(n));
-
-    std::generate_n(back_inserter(body_parts_), n, [&, i = 0]() mutable {
-        char key[] = "body_\0\0";
-        if (n <= 9) {
-            *(std::end(key) - 3) = static_cast<char>('0' + i);
-        } else {
-            BK_ASSERT(n <= 99);
-            *(std::end(key) - 2) = static_cast<char>('0' + i / 10);
-            *(std::end(key) - 3) = static_cast<char>('0' + i % 10);
-        }
+    BK_ASSERT(body_size_() <= body_plan::max_parts);
+}
 
-        ++i;
+entity::entity(entity&& other) noexcept
+  : object {std::move(other)}
+  , item_deleter_ {other.item_deleter_}
+  , body_plan_    {other.body_plan_}
+  , equip_slots_  (other.equip_slots_)
+  , max_health_   {other.max_health_}
+  , cur_health_   {other.cur_health_}
+{
+    fill(other.equip_slots_, item_instance_id {});
+}
 
-        auto const id = def.properties.value_or(
-            entity_property_id {djb2_hash_32(key)}, 0);
+entity& entity::operator=(entity&& other) noexcept {
+    object::operator=(std::move(other));
 
-        BK_ASSERT(id != 0);
+    // the equipment previously owned by this is cleaned up by other, which
+    // also needs the plan that says how many slots there are
+    item_deleter_ = other.item_deleter_;
+    max_health_   = other.max_health_;
+    cur_health_   = other.cur_health_;
+    std::swap(body_plan_,   other.body_plan_);
+    std::swap(equip_slots_, other.equip_slots_);
 
-        return body_part {id, item_instance_id {}};
-    });
+    return *this;
 }
 
 bool entity::is_alive() const noexcept {
@@ -393,55 +401,55 @@ bool entity::modify_health(int16_t const delta) noexcept {
     return is_alive();
 }
 
-body_part const* entity::body_begin() const noexcept {
-    return body_parts_.data();
+size_t entity::body_size_() const noexcept {
+    return body_plan_
+      ? body_plan_->parts.size()
+      : size_t {0};
 }
 
-body_part const* entity::body_end() const noexcept {
-    return body_parts_.data() + body_parts_.size();
+body_part_iterator entity::body_begin() const noexcept {
+    return {body_plan_ ? body_plan_->parts.data() : nullptr
+          , equip_slots_.data()};
 }
 
-namespace {
-
-template <typename Container, typename Predicate>
-void entity_equip_impl(Container&& parts, item_pile& source, item_instance_id const id, Predicate pred) {
-    using std::begin;
-    using std::end;
+body_part_iterator entity::body_end() const noexcept {
+    auto const n = body_size_();
+    return {body_plan_ ? body_plan_->parts.data() + n : nullptr
+          , equip_slots_.data() + n};
+}
 
-    auto const last = end(parts);
-    auto const it = std::find_if(begin(parts), last, pred);
+template <typename Predicate>
+void entity::equip_(item_instance_id const id, Predicate pred) {
+    auto const first = body_begin();
+    auto const last  = body_end();
+    auto const i = static_cast<size_t>(
+        std::distance(first, std::find_if(first, last, pred)));
 
-    BK_ASSERT((it != last)
-           && (it->equip == item_instance_id {}));
+    BK_ASSERT((i < body_size_())
+           && (equip_slots_[i] == item_instance_id {}));
 
-    auto itm = source.remove_item(id);
+    auto itm = items().remove_item(id);
     BK_ASSERT(!!itm);
 
-    it->equip = itm.release();
+    equip_slots_[i] = itm.release();
 }
 
-} // namespace
-
 void entity::equip(item_instance_id const id) {
-    entity_equip_impl(body_parts_, items(), id
-      , [&](body_part const& part) { return part.is_free(); });
+    equip_(id, [&](body_part const& part) { return part.is_free(); });
 }
 
 void entity::equip(body_part_id const part_id, item_instance_id const id) {
-    entity_equip_impl(body_parts_, items(), id
-      , [&](body_part const& part) { return part.id == part_id; });
+    equip_(id, [&](body_part const& part) { return part.id == part_id; });
 }
 
-
 void entity::unequip(item_instance_id const id) {
-    auto const last = std::end(body_parts_);
-    auto const it = std::find_if(begin(body_parts_), last
-      , [&](body_part const& part) { return part.equip == id; });
+    auto const first = std::begin(equip_slots_);
+    auto const last  = first + static_cast<ptrdiff_t>(body_size_());
+    auto const it    = std::find(first, last, id);
 
-    BK_ASSERT(it != last
-           && it->equip == id);
+    BK_ASSERT(it != last);
 
-    it->equip = item_instance_id {};
+    *it = item_instance_id {};
 
     items().add_item({id, item_deleter_});
 }
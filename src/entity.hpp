@@ -5,7 +5,10 @@
 #include "entity_def.hpp"
 #include "object.hpp"
 
+#include <array>
+#include <iterator>
 #include <cstdint>
+#include <cstddef>
 
 namespace boken { class item; }
 namespace boken { class random_state; }
@@ -22,6 +25,54 @@ struct body_part {
     item_instance_id equip;
 };
 
+//! Iterates over the body parts of an entity; the part ids come from the
+//! shared body_plan, and the equipped items from the entity itself. Parts are
+//! yielded by value.
+class body_part_iterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = body_part;
+    using difference_type   = ptrdiff_t;
+    using pointer           = body_part const*;
+    using reference         = body_part;
+
+    body_part_iterator(
+        body_part_id     const* const id
+      , item_instance_id const* const equip
+    ) noexcept
+      : id_    {id}
+      , equip_ {equip}
+    {
+    }
+
+    body_part operator*() const noexcept {
+        return {*id_, *equip_};
+    }
+
+    body_part_iterator& operator++() noexcept {
+        ++id_;
+        ++equip_;
+        return *this;
+    }
+
+    body_part_iterator operator++(int) noexcept {
+        auto result = *this;
+        ++(*this);
+        return result;
+    }
+
+    bool operator==(body_part_iterator const& other) const noexcept {
+        return equip_ == other.equip_;
+    }
+
+    bool operator!=(body_part_iterator const& other) const noexcept {
+        return !(*this == other);
+    }
+private:
+    body_part_id     const* id_;
+    item_instance_id const* equip_;
+};
+
 class entity : public object<entity, entity_definition, entity_instance_id> {
 public:
     ~entity();
@@ -37,8 +88,9 @@ public:
     entity(entity const&) = delete;
     entity& operator=(entity const&) = delete;
 
-    entity(entity&&) = default;
-    entity& operator=(entity&&) = default;
+    //! moved-from entities no longer own any equipped items.
+    entity(entity&& other) noexcept;
+    entity& operator=(entity&& other) noexcept;
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     // stats
@@ -46,8 +98,8 @@ public:
     bool is_alive() const noexcept;
     bool modify_health(int16_t delta) noexcept;
 
-    body_part const* body_begin() const noexcept;
-    body_part const* body_end() const noexcept;
+    body_part_iterator body_begin() const noexcept;
+    body_part_iterator body_end() const noexcept;
 
     // equip assumes that all prerequisites for an item are already met.
     // always check with can_equip_item first before calling this function.
@@ -60,8 +112,15 @@ public:
     // always check with can_unequip_item first before calling this function.
     void unequip(item_instance_id id);
 private:
+    size_t body_size_() const noexcept;
+
+    template <typename Predicate>
+    void equip_(item_instance_id id, Predicate pred);
+
     std::reference_wrapper<item_deleter const> item_deleter_;
-    std::vector<body_part> body_parts_;
+
+    body_plan const* body_plan_;
+    std::array<item_instance_id, body_plan::max_parts> equip_slots_ {};
 
     int16_t max_health_;
     int16_t cur_health_;
@@ -3,12 +3,26 @@
 #include "definition.hpp"
 #include "types.hpp"
 
+#include <vector>
 #include <cstdint>
+#include <cstddef>
+
+namespace boken { class behavior_program; }
 
 namespace boken {
 
 using entity_property_value = uint32_t;
 
+//! The layout of the equipment slots (body parts) of an entity. Plans are
+//! interned and owned by the game_database; every definition with the same
+//! layout shares the same plan.
+struct body_plan {
+    //! the maximum number of parts any plan can have.
+    static constexpr size_t max_parts = 16;
+
+    std::vector<body_part_id> parts;
+};
+
 struct entity_definition : basic_definition<entity_definition
                                           , entity_id
                                           , entity_property_id
@@ -17,6 +31,14 @@ struct entity_definition : basic_definition<entity_definition
     using basic_definition::basic_definition;
 
     int16_t health_per_level {1}; //TODO
+
+    //! the body plan for this type of entity, or nullptr if it has no body
+    //! parts; set by the game_database.
+    body_plan const* body {nullptr};
+
+    //! the compiled behavior named by the ai_type property, or the "default"
+    //! behavior if there is none; set by the game_database.
+    behavior_program const* behavior {nullptr};
 };
 
 } //namespace boken
@@ -33,4 +33,17 @@ entity_property_value get_property_value_or(
 //! return whether or not an entity is capable of equipping items
 bool can_equip(const_entity_descriptor e) noexcept;
 
+//! The number of scheduler ticks in a game turn.
+constexpr int32_t ticks_per_turn = 100;
+
+//! The speed of an entity without a speed property.
+constexpr entity_property_value speed_normal = 100;
+
+//! The speed of an entity; an entity with speed_normal acts once per turn.
+entity_property_value speed_of(const_entity_descriptor e) noexcept;
+
+//! The number of scheduler ticks an action takes for the entity @p e.
+//! @returns A value > 0.
+int32_t action_ticks(const_entity_descriptor e) noexcept;
+
 } // namespace boken
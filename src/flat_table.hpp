@@ -0,0 +1,212 @@
+#pragma once
+
+#include "math_types.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace boken {
+
+//! A read-mostly associative table for data that is built once and then only
+//! queried. Values are staged with insert() and the table is then sorted and
+//! checked for duplicate keys by freeze().
+//!
+//! Keys and values are kept in two separate parallel arrays sorted by key. When
+//! the table is frozen a minimal-ish perfect hash of the form
+//! (key * seed) >> shift is searched for; if one is found a lookup is a single
+//! multiply, a load from the slot array and one key comparison. Otherwise
+//! lookups fall back to a binary search over the keys.
+//!
+//! Key must be convertible to a uint32_t via value_cast.
+template <typename Key, typename Value>
+class flat_table {
+public:
+    using key_type    = Key;
+    using value_type  = Value;
+    using size_type   = size_t;
+
+    size_type size()   const noexcept { return keys_.size(); }
+    bool      empty()  const noexcept { return keys_.empty(); }
+    bool      frozen() const noexcept { return frozen_; }
+
+    void reserve(size_type const n) {
+        keys_.reserve(n);
+        values_.reserve(n);
+    }
+
+    //! Stage a new value. Lookups are only valid after freeze() is called.
+    void insert(key_type const key, value_type value) {
+        BK_ASSERT(!frozen_);
+        keys_.push_back(key);
+        values_.push_back(std::move(value));
+    }
+
+    //! Sort the staged values and resolve any duplicate keys.
+    //! @param on_duplicate A function of the form
+    //!        f(value_type& kept, value_type& duplicate) -> bool
+    //!        invoked for each value with the same key as a value staged
+    //!        before it. Returning true indicates that the duplicate was
+    //!        merged into the kept value; returning false indicates a
+    //!        collision. In either case the duplicate is discarded.
+    //! @returns The number of collisions.
+    template <typename BinaryF>
+    size_type freeze(BinaryF on_duplicate) {
+        BK_ASSERT(!frozen_);
+        frozen_ = true;
+
+        auto const n = keys_.size();
+
+        // sort a permutation (stable; the first value staged wins) and then
+        // apply it.
+        std::vector<uint32_t> order(n);
+        std::iota(std::begin(order), std::end(order), uint32_t {0});
+        std::stable_sort(std::begin(order), std::end(order)
+          , [&](uint32_t const a, uint32_t const b) noexcept {
+                return keys_[a] < keys_[b];
+            });
+
+        std::vector<key_type>   keys;
+        std::vector<value_type> values;
+        keys.reserve(n);
+        values.reserve(n);
+
+        size_type collisions = 0;
+
+        for (auto const i : order) {
+            if (!keys.empty() && keys.back() == keys_[i]) {
+                if (!on_duplicate(values.back(), values_[i])) {
+                    ++collisions;
+                }
+                continue;
+            }
+
+            keys.push_back(keys_[i]);
+            values.push_back(std::move(values_[i]));
+        }
+
+        keys.shrink_to_fit();
+        values.shrink_to_fit();
+
+        keys_   = std::move(keys);
+        values_ = std::move(values);
+
+        build_index_();
+
+        return collisions;
+    }
+
+    //! Freeze the table treating any duplicate key as a collision.
+    size_type freeze() {
+        return freeze([](value_type const&, value_type const&) noexcept {
+            return false; });
+    }
+
+    //! @returns A pointer to the value associated with @p key, otherwise
+    //!          nullptr.
+    value_type const* find(key_type const key) const noexcept {
+        BK_ASSERT(frozen_);
+
+        if (!slots_.empty()) {
+            auto const i = slots_[slot_of_(key, seed_, shift_)];
+            return (i < keys_.size() && keys_[i] == key)
+              ? values_.data() + i
+              : nullptr;
+        }
+
+        auto const first = keys_.data();
+        auto const last  = first + keys_.size();
+        auto const it    = std::lower_bound(first, last, key);
+
+        return (it != last && *it == key)
+          ? values_.data() + (it - first)
+          : nullptr;
+    }
+
+    value_type* find(key_type const key) noexcept {
+        return const_cast<value_type*>(
+            static_cast<flat_table const*>(this)->find(key));
+    }
+
+    auto begin() const noexcept { return values_.begin(); }
+    auto end()   const noexcept { return values_.end(); }
+
+    //! @note keys are fixed; values can be updated in place.
+    auto begin() noexcept { return values_.begin(); }
+    auto end()   noexcept { return values_.end(); }
+
+    //! @returns true if lookups use the perfect hash rather than a search.
+    bool is_perfectly_hashed() const noexcept { return !slots_.empty(); }
+private:
+    static uint32_t slot_of_(
+        key_type const key
+      , uint32_t const seed
+      , uint32_t const shift
+    ) noexcept {
+        return (value_cast<uint32_t>(key) * seed) >> shift;
+    }
+
+    //! Try to find a seed and table size (at most 8 times the number of keys)
+    //! which map every key to a distinct slot.
+    void build_index_() {
+        slots_.clear();
+
+        auto const n = static_cast<uint32_t>(keys_.size());
+        if (n == 0) {
+            return;
+        }
+
+        uint32_t min_bits = 1;
+        while ((uint32_t {1} << min_bits) < n) {
+            ++min_bits;
+        }
+
+        constexpr int      max_tries  = 64;
+        constexpr uint32_t extra_bits = 3;
+
+        std::vector<uint32_t> slots;
+
+        for (auto bits = min_bits; bits <= min_bits + extra_bits && bits < 32; ++bits) {
+            auto const shift = 32u - bits;
+            auto const size  = size_t {1} << bits;
+
+            // odd multipliers derived from the golden ratio
+            auto seed = uint32_t {0x9E3779B1u};
+            for (int i = 0; i < max_tries; ++i, seed += 2 * 0x9E3779B9u) {
+                slots.assign(size, n);
+
+                bool ok = true;
+                for (uint32_t k = 0; k < n; ++k) {
+                    auto& slot = slots[slot_of_(keys_[k], seed, shift)];
+                    if (slot != n) {
+                        ok = false;
+                        break;
+                    }
+                    slot = k;
+                }
+
+                if (ok) {
+                    slots_ = std::move(slots);
+                    seed_  = seed;
+                    shift_ = shift;
+                    return;
+                }
+            }
+        }
+    }
+private:
+    std::vector<key_type>   keys_;
+    std::vector<value_type> values_;
+    std::vector<uint32_t>   slots_;
+    uint32_t                seed_   = 0;
+    uint32_t                shift_  = 0;
+    bool                    frozen_ = false;
+};
+
+} //namespace boken
@@ -4,12 +4,15 @@
 
 #include "bkassert/assert.hpp"
 
+#include <algorithm>
+#include <array>
 #include <vector>
 #include <queue>
 #include <type_traits>
 #include <limits>
 #include <iterator>
 #include <tuple>
+#include <utility>
 
 #include <cstdint>
 #include <cstddef>
@@ -260,6 +263,33 @@ auto count_components(vertex_data<T> const& data, Container& out, size_t const n
     return std::make_tuple(min_i, max_i, out[min_i], out[max_i]);
 }
 
+//! Call @p f for each of the 8 neighbors of @p p which are within the bounds
+//! of @p graph, satisfy @p pred, and are passable; in that order, so that
+//! @p pred can skip the (often more costly) passability test. This is the
+//! for_each_neighbor_if of any grid graph which allows diagonal moves.
+//! Graph must provide is_in_bounds and is_passable as described below.
+template <typename Graph, typename Predicate, typename UnaryF>
+void for_each_neighbor8_if(
+    Graph const&                graph
+  , typename Graph::point const p
+  , Predicate                   pred
+  , UnaryF                      f
+) {
+    using v = vec2<int>;
+    constexpr std::array<v, 8> dir {
+        v {-1, -1}, v { 0, -1}, v { 1, -1}
+      , v {-1,  0},             v { 1,  0}
+      , v {-1,  1}, v { 0,  1}, v { 1,  1}
+    };
+
+    for (auto const& d : dir) {
+        auto const q = p + d;
+        if (graph.is_in_bounds(q) && pred(q) && graph.is_passable(q)) {
+            f(q);
+        }
+    }
+}
+
 //! Graph must support the following interface:
 //! Graph {
 //!   using point = <point type>
@@ -453,4 +483,241 @@ inline auto diagonal_heuristic() noexcept {
     };
 }
 
+//! An incremental planner (D* Lite, Koenig & Likhachev) for an agent walking
+//! from a start toward a fixed goal over a graph whose passability changes as
+//! it goes.
+//!
+//! The search runs backward from the goal, so the cost to the goal is known
+//! for every node already searched. When nodes change, only the nodes whose
+//! cost depends upon them are searched again, rather than the whole path; the
+//! more of the path that is unaffected, the cheaper the repair compared with a
+//! new search.
+//!
+//! Graph has the same interface as for a_star_pather, and must treat the start
+//! as passable (i.e. the node the agent is on). @p Heuristic is as for
+//! a_star_pather::search, but must not overestimate the cost.
+template <typename Graph, typename Heuristic = decltype(diagonal_heuristic())>
+class d_star_lite_pather {
+public:
+    using point = typename Graph::point;
+
+    explicit d_star_lite_pather(Heuristic h)
+      : h_ {std::move(h)}
+    {
+    }
+
+    //! Discard any previous state and search for a path from @p start to
+    //! @p goal.
+    //! @returns true if there is a path; otherwise false.
+    bool plan(Graph const& graph, point const start, point const goal) {
+        w_ = graph.width();
+
+        auto const n = static_cast<size_t>(graph.size());
+        g_.assign(n, infinity());
+        rhs_.assign(n, infinity());
+        keys_.assign(n, key_t {});
+        queued_.assign(n, 0);
+        queue_.clear();
+
+        km_    = 0;
+        start_ = start;
+        goal_  = goal;
+
+        rhs_[index_of_(goal)] = 0;
+        push_(goal);
+
+        return replan(graph);
+    }
+
+    //! The agent has moved to @p p.
+    //! @note Call before update() for any changes seen from the new position.
+    void move_to(point const p) noexcept {
+        km_ += h_(start_, p);
+        start_ = p;
+    }
+
+    //! The passability of, or cost to enter, @p p has changed.
+    //! @note The path isn't repaired until the next call to replan().
+    void update(Graph const& graph, point const p) {
+        update_vertex_(graph, p);
+        graph.for_each_neighbor_if(p, always_
+          , [&](point const q) { update_vertex_(graph, q); });
+    }
+
+    //! Repair the path after calls to move_to() and update().
+    //! @returns true if there is a path; otherwise false.
+    bool replan(Graph const& graph) {
+        auto const s = index_of_(start_);
+        expanded_ = 0;
+
+        for (;;) {
+            while (!queue_.empty() && is_stale_(queue_.front())) {
+                pop_();
+            }
+
+            if (queue_.empty()) {
+                break;
+            }
+
+            auto const k_old = queue_.front().first;
+            if (!(k_old < calculate_key_(start_)) && rhs_[s] == g_[s]) {
+                break;
+            }
+
+            auto const u = pop_();
+            auto const i = index_of_(u);
+            ++expanded_;
+
+            auto const k_new = calculate_key_(u);
+            if (k_old < k_new) {
+                push_(u);
+            } else if (g_[i] > rhs_[i]) {
+                g_[i] = rhs_[i];
+                graph.for_each_neighbor_if(u, always_
+                  , [&](point const q) { update_vertex_(graph, q); });
+            } else {
+                g_[i] = infinity();
+                update(graph, u);
+            }
+        }
+
+        return rhs_[s] < infinity();
+    }
+
+    //! Write the path from the start to the goal, both included; nothing if
+    //! there is no path.
+    template <typename OutputIt>
+    void copy_path(Graph const& graph, OutputIt it) const {
+        if (rhs_[index_of_(start_)] >= infinity()) {
+            return;
+        }
+
+        auto p = start_;
+        *it = p;
+        ++it;
+
+        // the limit is just a guard against a bad heuristic
+        for (auto n = graph.size(); p != goal_ && n > 0; --n) {
+            auto best      = p;
+            auto best_cost = infinity();
+
+            graph.for_each_neighbor_if(p, always_, [&](point const q) {
+                auto const c = add_(graph.cost(p, q), g_[index_of_(q)]);
+                if (c < best_cost) {
+                    best      = q;
+                    best_cost = c;
+                }
+            });
+
+            if (best_cost >= infinity()) {
+                break;
+            }
+
+            p = best;
+            *it = p;
+            ++it;
+        }
+    }
+
+    point start() const noexcept { return start_; }
+    point goal()  const noexcept { return goal_; }
+
+    //! The number of nodes expanded by the last call to plan() or replan().
+    int32_t expanded() const noexcept { return expanded_; }
+private:
+    using key_t   = std::pair<int32_t, int32_t>;
+    using entry_t = std::pair<key_t, point>;
+
+    static constexpr int32_t infinity() noexcept {
+        return std::numeric_limits<int32_t>::max() / 4;
+    }
+
+    static constexpr bool always_(point) noexcept { return true; }
+
+    static int32_t add_(int32_t const cost, int32_t const g) noexcept {
+        return (g >= infinity()) ? infinity() : std::min(infinity(), g + cost);
+    }
+
+    size_t index_of_(point const p) const noexcept {
+        return static_cast<size_t>(value_cast(p.x) + value_cast(p.y) * w_);
+    }
+
+    key_t calculate_key_(point const p) const noexcept {
+        auto const i = index_of_(p);
+        auto const m = std::min(g_[i], rhs_[i]);
+        return {m + h_(start_, p) + km_, m};
+    }
+
+    void update_vertex_(Graph const& graph, point const p) {
+        auto const i = index_of_(p);
+
+        if (p != goal_) {
+            auto r = infinity();
+            if (graph.is_passable(p)) {
+                graph.for_each_neighbor_if(p, always_, [&](point const q) {
+                    r = std::min(r, add_(graph.cost(p, q), g_[index_of_(q)]));
+                });
+            }
+
+            rhs_[i] = r;
+        }
+
+        // entries already in the queue become stale
+        queued_[i] = 0;
+        if (g_[i] != rhs_[i]) {
+            push_(p);
+        }
+    }
+
+    // the queue is a heap with lazy removal: an entry is only current if its
+    // key is the one last pushed for the node, and the node is still queued.
+    bool is_stale_(entry_t const& e) const noexcept {
+        auto const i = index_of_(e.second);
+        return !queued_[i] || keys_[i] != e.first;
+    }
+
+    static bool greater_(entry_t const& a, entry_t const& b) noexcept {
+        return b.first < a.first;
+    }
+
+    void push_(point const p) {
+        auto const i = index_of_(p);
+        auto const k = calculate_key_(p);
+
+        keys_[i]   = k;
+        queued_[i] = 1;
+
+        queue_.push_back({k, p});
+        std::push_heap(begin(queue_), end(queue_), greater_);
+    }
+
+    point pop_() noexcept {
+        std::pop_heap(begin(queue_), end(queue_), greater_);
+        auto const p = queue_.back().second;
+        queue_.pop_back();
+
+        queued_[index_of_(p)] = 0;
+        return p;
+    }
+private:
+    Heuristic h_;
+
+    std::vector<int32_t> g_;      //!< the cost to the goal as last expanded
+    std::vector<int32_t> rhs_;    //!< the cost to the goal via the best neighbor
+    std::vector<key_t>   keys_;   //!< the key last queued for each node
+    std::vector<uint8_t> queued_;
+    std::vector<entry_t> queue_;
+
+    point   start_ {};
+    point   goal_  {};
+    int32_t km_       {0}; //!< the total distance the agent has moved
+    int32_t w_        {0};
+    int32_t expanded_ {0};
+};
+
+template <typename Graph, typename Heuristic>
+auto make_d_star_lite_pather(Graph const&, Heuristic h) {
+    return d_star_lite_pather<Graph, Heuristic> {std::move(h)};
+}
+
 } // namespace boken
@@ -14,6 +14,7 @@ struct tag_id_instance_item;
 struct tag_id_property_item;
 struct tag_id_region;
 struct tag_id_body_part;
+struct tag_id_behavior;
 
 using entity_id          = tagged_value<uint32_t, tag_id_entity>;
 using entity_instance_id = tagged_value<uint32_t, tag_id_instance_entity>;
@@ -22,5 +23,6 @@ using item_id            = tagged_value<uint32_t, tag_id_item>;
 using item_instance_id   = tagged_value<uint32_t, tag_id_instance_item>;
 using item_property_id   = tagged_value<uint32_t, tag_id_property_item>;
 using body_part_id       = tagged_value<uint32_t, tag_id_body_part>;
+using behavior_id        = tagged_value<uint32_t, tag_id_behavior>;
 
 } // namespace boken
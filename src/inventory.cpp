@@ -72,6 +72,7 @@ public:
 
     //--------------------------------------------------------------------------
     void set_title(std::string title) final override {
+        ++generation_;
         title_.layout(trender_, std::move(title));
     }
 
@@ -99,12 +100,14 @@ public:
 
     //--------------------------------------------------------------------------
     bool show() noexcept final override {
+        ++generation_;
         bool const result = is_visible_;
         is_visible_ = true;
         return result;
     }
 
     bool hide() noexcept final override {
+        ++generation_;
         bool const result = is_visible_;
         is_visible_ = false;
         return result;
@@ -115,6 +118,7 @@ public:
     }
 
     bool toggle_visible() noexcept final override {
+        ++generation_;
         bool const result = is_visible_;
         is_visible_ = !is_visible_;
         return result;
@@ -139,6 +143,7 @@ public:
 
     //--------------------------------------------------------------------------
     void scroll_by(sizei32y const dy) noexcept final override {
+        ++generation_;
         auto const h = metrics_.client_frame.height();
 
         if (content_h_ <= h) {
@@ -151,6 +156,7 @@ public:
     }
 
     void scroll_by(sizei32x const dx) noexcept final override {
+        ++generation_;
         auto const w = metrics_.client_frame.width();
 
         if (content_w_ <= w) {
@@ -163,6 +169,8 @@ public:
     }
 
     void scroll_into_view(int const c, int const r) noexcept final override {
+        ++generation_;
+
         if (empty()) {
             BK_ASSERT(c == 0 && r == 0);
             return;
@@ -203,6 +211,8 @@ public:
 
     //--------------------------------------------------------------------------
     void resize_to(sizei32x const w, sizei32y const h) noexcept final override {
+        ++generation_;
+
         auto&       m = metrics_;
         auto const& c = config_;
 
@@ -270,6 +280,8 @@ public:
     }
 
     void move_by(vec2i32 const v) noexcept final override {
+        ++generation_;
+
         auto& m = metrics_;
 
         m.frame        += v;
@@ -289,6 +301,8 @@ public:
     }
 
     int indicate(int const n) noexcept final override {
+        ++generation_;
+
         BK_ASSERT(n >= 0);
         auto const r = static_cast<int>(rows());
 
@@ -299,6 +313,8 @@ public:
     }
 
     int indicate_change_(int const n) noexcept {
+        ++generation_;
+
         auto const result = indicated_;
 
         auto const n_rows = rows();
@@ -328,6 +344,8 @@ public:
 
     //--------------------------------------------------------------------------
     void sort(std::initializer_list<int> const cols) noexcept final override {
+        ++generation_;
+
         std::sort(begin(sorted_), end(sorted_), [&](size_t const lhs, size_t const rhs) {
             for (int const c : cols) {
                 BK_ASSERT(c != 0);
@@ -356,6 +374,8 @@ public:
     }
 
     void sort(int const* const first, int const* const last) noexcept final override {
+        ++generation_;
+
         BK_ASSERT(( !first &&  !last)
                || (!!first && !!last));
 
@@ -415,6 +435,7 @@ public:
 
     void add_rows(item_instance_id const* const first, item_instance_id const* const last) final override {
         BK_ASSERT(!!first && !!last);
+        ++generation_;
 
         auto const first_col = begin(cols_);
         auto const last_col  = end(cols_);
@@ -451,6 +472,7 @@ public:
 
     void remove_rows(int const* const first, int const* const last) noexcept final override {
         BK_ASSERT(!!first && !!last);
+        ++generation_;
 
         std::for_each(first, last, [&](int const i) noexcept {
             BK_ASSERT(check_row_(i));
@@ -475,6 +497,7 @@ public:
     }
 
     void clear_rows() noexcept final override {
+        ++generation_;
         scroll_pos_.y = 0;
         rows_.clear();
         row_data_.clear();
@@ -491,6 +514,7 @@ public:
     //--------------------------------------------------------------------------
     bool selection_toggle(int const row) final override {
         BK_ASSERT(check_row_(row));
+        ++generation_;
         return get_row_data_(row).selected = !get_row_data_(row).selected;
     }
 
@@ -500,6 +524,7 @@ public:
     }
 
     void selection_union(std::initializer_list<int> const rows) final override {
+        ++generation_;
         for_each_index_of(sorted_, begin(rows), end(rows), [&](auto const i) {
             BK_ASSERT(i >= 0);
             row_data_[static_cast<size_t>(i)].selected = true;
@@ -507,6 +532,8 @@ public:
     }
 
     int selection_clear() final override {
+        ++generation_;
+
         int n = 0;
         for (auto& row : row_data_) {
             if (row.selected) {
@@ -575,6 +602,10 @@ public:
 
     //--------------------------------------------------------------------------
     void layout() noexcept final override;
+
+    uint32_t generation() const noexcept final override {
+        return generation_;
+    }
 private:
     template <typename T>
     bool check_row_(T const r) const noexcept {
@@ -626,8 +657,9 @@ private:
     //!< temporary buffer used by get_selection
     std::vector<int> mutable selected_;
 
-    int  indicated_  {0};
-    bool is_visible_ {true};
+    int      indicated_  {0};
+    bool     is_visible_ {true};
+    uint32_t generation_ {0};
 private:
     template <typename T>
     size_t sorted_index_(T const index) const noexcept {
@@ -670,6 +702,8 @@ void inventory_list_impl::add_column(
   , int const      insert_before
   , sizei16x const width
 ) {
+    ++generation_;
+
     auto const index = [&]() noexcept -> size_t {
         if (insert_before == insert_at_end) {
             return cols();
@@ -789,6 +823,8 @@ inventory_list_impl::hit_test(point2i32 const p0) const noexcept {
 }
 
 void inventory_list_impl::layout() noexcept {
+    ++generation_;
+
     auto const& c = config_;
 
     auto const get_max_col_w = [&](size_t const i) noexcept {
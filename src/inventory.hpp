@@ -185,6 +185,9 @@ public:
 
     //--------------------------------------------------------------------------
     virtual void layout() noexcept = 0;
+
+    //! Changes whenever anything which affects how the list is drawn does.
+    virtual uint32_t generation() const noexcept = 0;
 };
 
 std::unique_ptr<inventory_list> make_inventory_list(const_context  ctx
@@ -125,8 +125,13 @@ void merge_into_pile(
 
     // the default action on any failure is to preserve the item and add it to
     // the pile
+    bool is_open_stack = false;
     auto on_exit = BK_SCOPE_EXIT {
-        pile.add_item(std::move(itm_ptr));
+        if (itm) {
+            pile.add_item(std::move(itm_ptr), get_id(itm), is_open_stack);
+        } else {
+            pile.add_item(std::move(itm_ptr));
+        }
     };
 
     // if the item doesn't have a valid id, preserve the item anyway and add it
@@ -139,27 +144,48 @@ void merge_into_pile(
     constexpr auto p_cur_stack = property(item_property::current_stack_size);
 
     // if the item can't be stacked, just add the item to the pile
-    if (!get_property_value_or(itm, p_max_stack, 0)) {
+    auto const max_stack = get_property_value_or(itm, p_max_stack, 0);
+    if (!max_stack) {
         return;
     }
 
     auto src_cur_stack = get_property_value_or(itm, p_cur_stack, 0);
     BK_ASSERT(src_cur_stack > 0); // no zero sized stacks
 
-    for (auto const& id : pile) {
-        auto const i = item_descriptor {ctx, id};
+    auto const cur_stack_of = [&](item_descriptor const i) noexcept {
+        return get_property_value_or(i, p_cur_stack, 0);
+    };
 
-        // different item
-        if (i.def != itm.def) {
-            continue;
+    // items were added to the pile without going through this function; do a
+    // full scan (once) to find any stacks with space remaining. The index
+    // covers every definition, not just that of the item being merged.
+    if (!pile.has_stack_index()) {
+        pile.reset_stack_index();
+
+        for (auto const& id : pile) {
+            auto const i = item_descriptor {ctx, id};
+            auto const i_max_stack = get_property_value_or(i, p_max_stack, 0);
+            if (i_max_stack && cur_stack_of(i) < i_max_stack) {
+                pile.add_open_stack(get_id(i), id);
+            }
         }
+    }
+
+    auto const def_id = get_id(itm);
+
+    for (auto id = pile.find_open_stack(def_id)
+       ; id != item_instance_id {}
+       ; id = pile.find_open_stack(def_id)
+    ) {
+        auto const i = item_descriptor {ctx, id};
+        BK_ASSERT(i.def == itm.def);
 
-        auto const max_stack = get_property_value_or(i, p_max_stack, 0);
-        auto const cur_stack = get_property_value_or(i, p_cur_stack, 0);
+        auto const cur_stack = cur_stack_of(i);
 
         // no space in the stack to merge quantity
         if (cur_stack >= max_stack) {
             BK_ASSERT(cur_stack <= max_stack);
+            pile.remove_open_stack(id);
             continue;
         }
 
@@ -169,6 +195,10 @@ void merge_into_pile(
         src_cur_stack -= n;
         i.obj.add_or_update_property({p_cur_stack, cur_stack + n});
 
+        if (n == spare_stack) {
+            pile.remove_open_stack(id);
+        }
+
         if (src_cur_stack <= 0) {
             on_exit.dismiss();
             return;
@@ -177,6 +207,7 @@ void merge_into_pile(
 
     BK_ASSERT(src_cur_stack > 0);
     itm.obj.add_or_update_property({p_cur_stack, src_cur_stack});
+    is_open_stack = src_cur_stack < max_stack;
 }
 
 void merge_into_pile(
@@ -362,17 +393,29 @@ bool can_equip(const_item_descriptor const i) noexcept {
     return !!get_property_value_or(i, p_can_equip, 0);
 }
 
-namespace {
+unique_item create_object(
+    game_database const&   db
+  , world&                 w
+  , item_definition const& def
+  , random_state&          rng
+) {
+    return create_object(w, [&](item_instance_id const instance) {
+        return item {get_item_deleter(w), db, def, instance, rng};
+    });
+}
 
-item create_object(
-    game_database    const& db
-  , world            const& w
-  , item_instance_id const  instance
+//=====--------------------------------------------------------------------=====
+//                                  item
+//=====--------------------------------------------------------------------=====
+item::item(
+    item_deleter     const& deleter
+  , game_database    const& db
   , item_definition  const& def
+  , item_instance_id const  instance
   , random_state&           rng
-) {
-    item result {get_item_deleter(w), instance, def.id};
-
+)
+  : object {deleter, instance, def.id}
+{
     //
     // check if the item type can be stacked, and if so set its current stack
     // size.
@@ -381,30 +424,11 @@ item create_object(
         property(item_property::stack_size), 0);
 
     if (stack_size > 0) {
-        result.add_or_update_property(
+        add_or_update_property(
             property(item_property::current_stack_size), 1);
     }
-
-    return result;
 }
 
-} // namespace
-
-unique_item create_object(
-    game_database const&   db
-  , world&                 w
-  , item_definition const& def
-  , random_state&          rng
-) {
-    return create_object(w, [&](item_instance_id const instance) {
-        return create_object(db, w, instance, def, rng);
-    });
-}
-
-//=====--------------------------------------------------------------------=====
-//                                  item
-//=====--------------------------------------------------------------------=====
-
 //=====--------------------------------------------------------------------=====
 //                                  item_pile
 //=====--------------------------------------------------------------------=====
@@ -427,6 +451,20 @@ item_instance_id item_pile::operator[](size_t const index) const noexcept {
 
 void item_pile::add_item(unique_item item) {
     items_.push_back(item.release());
+    stacks_valid_ = false;
+}
+
+void item_pile::add_item(
+    unique_item   item
+  , item_id const def
+  , bool    const is_open_stack
+) {
+    auto const id = item.release();
+    items_.push_back(id);
+
+    if (is_open_stack) {
+        add_open_stack(def, id);
+    }
 }
 
 unique_item item_pile::remove_item(item_instance_id const id) {
@@ -436,6 +474,7 @@ unique_item item_pile::remove_item(item_instance_id const id) {
     }
 
     items_.erase(it);
+    remove_open_stack(id);
     return unique_item {id, deleter_};
 }
 
@@ -444,7 +483,48 @@ unique_item item_pile::remove_item(size_t const pos) {
 
     auto const id = items_[pos];
     items_.erase(std::begin(items_) + static_cast<ptrdiff_t>(pos));
+    remove_open_stack(id);
     return unique_item {id, deleter_};
 }
 
+item_instance_id item_pile::find_open_stack(item_id const def) const noexcept {
+    BK_ASSERT(stacks_valid_);
+
+    auto const it = stacks_.find(def);
+    return (it != std::end(stacks_))
+      ? it->second
+      : item_instance_id {};
+}
+
+void item_pile::add_open_stack(item_id const def, item_instance_id const id) {
+    if (stacks_valid_ && stack_defs_.emplace(id, def).second) {
+        stacks_.emplace(def, id);
+    }
+}
+
+void item_pile::remove_open_stack(item_instance_id const id) noexcept {
+    auto const it = stack_defs_.find(id);
+    if (it == std::end(stack_defs_)) {
+        return;
+    }
+
+    auto const range = stacks_.equal_range(it->second);
+    stack_defs_.erase(it);
+
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second == id) {
+            stacks_.erase(i);
+            return;
+        }
+    }
+
+    BK_ASSERT(false);
+}
+
+void item_pile::reset_stack_index() noexcept {
+    stacks_.clear();
+    stack_defs_.clear();
+    stacks_valid_ = true;
+}
+
 } //namespace boken
@@ -10,12 +10,23 @@
 
 namespace boken { class game_database; }
 namespace boken { class string_buffer_base; }
+namespace boken { class random_state; }
 
 namespace boken {
 
 class item : public object<item, item_definition, item_instance_id> {
 public:
     using object::object;
+
+    //! Construct a new item with the initial (instance) properties required by
+    //! @p def.
+    item(
+        item_deleter const& deleter
+      , game_database const& db
+      , item_definition const& def
+      , item_instance_id instance
+      , random_state& rng
+    );
 };
 
 item_pile const& items(const_item_descriptor i) noexcept;
@@ -7,6 +7,7 @@
 #include "bkassert/assert.hpp"
 
 #include <vector>
+#include <unordered_map>
 #include <functional>
 #include <algorithm>
 #include <tuple>
@@ -21,6 +22,11 @@ namespace boken {
 //! Item ownership is wholly managed by item_piles and the world. Namely, the
 //! world briefly has ownership during item creation, but thereafter an
 //! item_pile maintains ownership.
+//!
+//! Each pile also keeps an index (by definition) of the stacks in the pile
+//! which aren't yet full; see merge_into_pile. Items added without stack
+//! information invalidate the index, and it must be rebuilt before it is next
+//! used.
 class item_pile {
 public:
     ~item_pile();
@@ -41,8 +47,37 @@ public:
 
     explicit operator bool() const noexcept { return !empty(); }
 
+    //! add an item without stack information; this invalidates the stack index.
     void add_item(unique_item item);
 
+    //! add an item of the type @p def; if @p is_open_stack the item is a stack
+    //! with space remaining and is added to the stack index.
+    void add_item(unique_item item, item_id def, bool is_open_stack);
+
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    //                              Stack index
+    //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    //! whether the stack index reflects the contents of the pile.
+    bool has_stack_index() const noexcept { return stacks_valid_; }
+
+    //! @pre has_stack_index()
+    //! @returns an item of type @p def which isn't a full stack, or an empty id
+    //!          if there is no such item.
+    item_instance_id find_open_stack(item_id def) const noexcept;
+
+    //! mark @p id (which must be in the pile) as a stack of @p def with space
+    //! remaining.
+    void add_open_stack(item_id def, item_instance_id id);
+
+    //! @p id is no longer a stack with space remaining; this only looks at the
+    //! open stacks of the same definition as @p id.
+    void remove_open_stack(item_instance_id id) noexcept;
+
+    //! clear the index and mark it as valid; the caller is expected to
+    //! (re)populate it with add_open_stack.
+    void reset_stack_index() noexcept;
+
     //! return an empty unique_item if no item with id exists
     unique_item remove_item(item_instance_id id);
     unique_item remove_item(size_t pos);
@@ -96,6 +131,7 @@ private:
                 itm.release();
             } else {
                 // the predicate did take ownership -- zero out the id
+                remove_open_stack(id);
                 id = item_instance_id {};
             }
         };
@@ -118,6 +154,10 @@ private:
 
     std::reference_wrapper<item_deleter const> deleter_;
     std::vector<item_instance_id> items_;
+
+    std::unordered_multimap<item_id, item_instance_id, identity_hash> stacks_;
+    std::unordered_map<item_instance_id, item_id, identity_hash>      stack_defs_;
+    bool stacks_valid_ = true;
 };
 
 inline auto begin(item_pile const& pile) noexcept { return pile.begin(); }
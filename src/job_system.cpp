@@ -0,0 +1,277 @@
+#include "job_system.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace boken {
+
+job_system::~job_system() = default;
+
+namespace {
+
+struct job_t {
+    job_system::job_f f;
+    task_group*       group;
+    uint32_t          tag;
+};
+
+//! A deque of jobs; the owner uses the back and thieves use the front.
+class job_deque {
+public:
+    void push_back(job_t j) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        jobs_.push_back(std::move(j));
+    }
+
+    bool pop_back(job_t& out) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        if (jobs_.empty()) {
+            return false;
+        }
+
+        out = std::move(jobs_.back());
+        jobs_.pop_back();
+        return true;
+    }
+
+    bool pop_front(job_t& out) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        if (jobs_.empty()) {
+            return false;
+        }
+
+        out = std::move(jobs_.front());
+        jobs_.pop_front();
+        return true;
+    }
+private:
+    std::mutex        mutex_;
+    std::deque<job_t> jobs_;
+};
+
+} // namespace
+
+class job_system_impl final : public job_system {
+public:
+    explicit job_system_impl(size_t const threads)
+    {
+        // deque 0 is shared by all threads not owned by the system
+        deques_.reserve(threads + 1);
+        for (size_t i = 0; i <= threads; ++i) {
+            deques_.push_back(std::make_unique<job_deque>());
+        }
+
+        workers_.reserve(threads);
+        for (size_t i = 1; i <= threads; ++i) {
+            workers_.emplace_back([this, i] {
+                worker_main_(static_cast<uint32_t>(i));
+            });
+        }
+    }
+
+    ~job_system_impl() {
+        {
+            std::lock_guard<std::mutex> lock {sleep_mutex_};
+            stop_ = true;
+        }
+
+        sleep_cv_.notify_all();
+
+        for (auto& t : workers_) {
+            t.join();
+        }
+    }
+
+    size_t worker_count() const noexcept final override {
+        return workers_.size();
+    }
+
+    void run(task_group& group, job_f job, uint32_t const tag) final override {
+        BK_ASSERT(!!job);
+
+        group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+        // count the job before it is visible to workers so that the count is
+        // never less than the number of jobs queued.
+        queued_.fetch_add(1, std::memory_order_release);
+        deques_[current_index_()]->push_back({std::move(job), &group, tag});
+
+        // taking the lock ensures a worker checking the count is either before
+        // its check (and will see the job) or already waiting (and is woken).
+        { std::lock_guard<std::mutex> lock {sleep_mutex_}; }
+        sleep_cv_.notify_one();
+    }
+
+    void wait(task_group& group) final override {
+        auto const self = current_index_();
+        while (!group.done()) {
+            if (!try_execute_(self)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void set_profiler(profile_f profiler) final override {
+        BK_ASSERT(queued_.load() == 0);
+        profiler_ = std::move(profiler);
+    }
+
+    stats_t stats() const noexcept final override {
+        return {executed_.load(), stolen_.load()};
+    }
+private:
+    uint32_t current_index_() const noexcept {
+        return tls_system_ == this ? tls_index_ : 0u;
+    }
+
+    void worker_main_(uint32_t const index) {
+        tls_system_ = this;
+        tls_index_  = index;
+
+        for (;;) {
+            if (try_execute_(index)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock {sleep_mutex_};
+            sleep_cv_.wait(lock, [&] {
+                return stop_ || queued_.load(std::memory_order_acquire) > 0;
+            });
+
+            if (stop_ && queued_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    //! Pop a job from the deque for @p self, or steal one from another deque
+    //! if it is empty, and execute it.
+    //! @returns false if there were no jobs to execute.
+    bool try_execute_(uint32_t const self) {
+        job_t j;
+        bool stolen = false;
+
+        if (!deques_[self]->pop_back(j)) {
+            auto const n = deques_.size();
+            for (size_t i = 1; i < n && !stolen; ++i) {
+                stolen = deques_[(self + i) % n]->pop_front(j);
+            }
+
+            if (!stolen) {
+                return false;
+            }
+        }
+
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+
+        if (profiler_) {
+            auto const start = clock_t::now();
+            j.f();
+            profiler_({self, j.tag, stolen, start, clock_t::now()});
+        } else {
+            j.f();
+        }
+
+        executed_.fetch_add(1, std::memory_order_relaxed);
+        if (stolen) {
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        j.group->pending_.fetch_sub(1, std::memory_order_acq_rel);
+
+        return true;
+    }
+private:
+    static thread_local job_system_impl const* tls_system_;
+    static thread_local uint32_t               tls_index_;
+
+    std::vector<std::unique_ptr<job_deque>> deques_;
+    std::vector<std::thread>                workers_;
+
+    std::mutex              sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool                    stop_ = false;
+
+    std::atomic<int64_t>  queued_   {0};
+    std::atomic<uint64_t> executed_ {0};
+    std::atomic<uint64_t> stolen_   {0};
+
+    profile_f profiler_;
+};
+
+thread_local job_system_impl const* job_system_impl::tls_system_ = nullptr;
+thread_local uint32_t               job_system_impl::tls_index_  = 0;
+
+std::unique_ptr<job_system> make_job_system(size_t threads) {
+    if (threads == 0) {
+        auto const hw = std::thread::hardware_concurrency();
+        threads = hw > 1 ? hw - 1 : 1;
+    }
+
+    return std::make_unique<job_system_impl>(threads);
+}
+
+void parallel_for(
+    job_system& jobs
+  , size_t      const n
+  , size_t      const grain
+  , std::function<void (size_t, size_t)> const& f
+) {
+    auto const step = std::max(grain, size_t {1});
+
+    task_group group;
+
+    // run all but the last range as jobs and the last one here
+    size_t first = 0;
+    for (; n - first > step; first += step) {
+        jobs.run(group, [&f, first, step] { f(first, first + step); });
+    }
+
+    if (first < n) {
+        f(first, n);
+    }
+
+    jobs.wait(group);
+}
+
+void parallel_for(
+    job_system& jobs
+  , recti32     const area
+  , sizei32x    const tile_w
+  , sizei32y    const tile_h
+  , std::function<void (recti32)> const& f
+) {
+    BK_ASSERT(value_cast(tile_w) > 0 && value_cast(tile_h) > 0);
+
+    auto const w  = value_cast(tile_w);
+    auto const h  = value_cast(tile_h);
+    auto const x0 = value_cast(area.x0);
+    auto const y0 = value_cast(area.y0);
+    auto const x1 = value_cast(area.x1);
+    auto const y1 = value_cast(area.y1);
+
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    auto const cols = static_cast<size_t>((x1 - x0 + w - 1) / w);
+    auto const rows = static_cast<size_t>((y1 - y0 + h - 1) / h);
+
+    parallel_for(jobs, cols * rows, 1, [&](size_t const first, size_t const last) {
+        for (auto i = first; i < last; ++i) {
+            auto const x = x0 + static_cast<int32_t>(i % cols) * w;
+            auto const y = y0 + static_cast<int32_t>(i / cols) * h;
+
+            f(recti32 {offi32x {x}, offi32y {y}
+                     , offi32x {std::min(x + w, x1)}, offi32y {std::min(y + h, y1)}});
+        }
+    });
+}
+
+} // namespace boken
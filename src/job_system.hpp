@@ -0,0 +1,102 @@
+#pragma once
+
+#include "math_types.hpp"  // for recti32
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace boken {
+
+//! A counter of outstanding jobs; a job_system::wait on the group returns once
+//! every job run as part of the group has completed.
+class task_group {
+    friend class job_system_impl;
+public:
+    task_group() = default;
+    task_group(task_group const&) = delete;
+    task_group& operator=(task_group const&) = delete;
+
+    bool done() const noexcept {
+        return pending_.load(std::memory_order_acquire) == 0;
+    }
+private:
+    std::atomic<uint32_t> pending_ {0};
+};
+
+//! A pool of worker threads each with its own deque of jobs. A worker pushes
+//! and pops jobs at the back of its own deque, and steals from the front of
+//! the deques of the other workers when its own is empty.
+//!
+//! Jobs can be run from any thread, including from within a job. A thread
+//! which waits on a task_group helps by executing jobs until the group is done,
+//! so waiting from within a job doesn't deadlock.
+class job_system {
+public:
+    using clock_t = std::chrono::high_resolution_clock;
+    using job_f   = std::function<void ()>;
+
+    struct job_profile {
+        uint32_t            worker; //!< 0 for threads not owned by the system
+        uint32_t            tag;    //!< user supplied (string hash)
+        bool                stolen; //!< whether the job was stolen
+        clock_t::time_point start;
+        clock_t::time_point end;
+    };
+
+    //! Invoked by the thread which ran a job after it completes.
+    using profile_f = std::function<void (job_profile const&)>;
+
+    struct stats_t {
+        uint64_t executed; //!< jobs executed
+        uint64_t stolen;   //!< jobs executed by a thread other than the one
+                           //!< which queued them
+    };
+
+    virtual ~job_system();
+
+    //! The number of worker threads owned by the system.
+    virtual size_t worker_count() const noexcept = 0;
+
+    //! Queue @p job as part of the group @p group.
+    //! @pre @p job doesn't throw.
+    virtual void run(task_group& group, job_f job, uint32_t tag = 0) = 0;
+
+    //! Execute jobs until every job in @p group has completed.
+    virtual void wait(task_group& group) = 0;
+
+    //! Set a function to be invoked after each job; an empty function disables
+    //! profiling.
+    //! @pre No jobs are queued or running.
+    virtual void set_profiler(profile_f profiler) = 0;
+
+    virtual stats_t stats() const noexcept = 0;
+};
+
+//! @param threads The number of worker threads; 0 to use one less than the
+//!        number of hardware threads, but at least one (the thread waiting
+//!        does work too).
+std::unique_ptr<job_system> make_job_system(size_t threads = 0);
+
+//! Invoke f(first, last) for consecutive sub ranges of [0, n) of at most
+//! @p grain elements, in parallel, and return once all have completed.
+void parallel_for(
+    job_system& jobs
+  , size_t      n
+  , size_t      grain
+  , std::function<void (size_t, size_t)> const& f);
+
+//! Invoke f(tile) for each tile of at most @p tile_w x @p tile_h covering
+//! @p area, in parallel, and return once all have completed.
+void parallel_for(
+    job_system&    jobs
+  , recti32        area
+  , sizei32x       tile_w
+  , sizei32y       tile_h
+  , std::function<void (recti32)> const& f);
+
+} // namespace boken
@@ -3,6 +3,7 @@
 
 #include "algorithm.hpp"
 #include "bsp_generator.hpp"    // for bsp_generator, etc
+#include "diffusion.hpp"
 #include "random.hpp"           // for random_state (ptr only), etc
 #include "random_algorithm.hpp"
 #include "tile.hpp"             // for tile_data_set, tile_type, tile_flags, etc
@@ -20,8 +21,11 @@
 #include <functional>           // for reference_wrapper, ref
 #include <iterator>             // for begin, end, back_insert_iterator, etc
 #include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>               // for vector
 
+#include <cmath>
 #include <cstdint>              // for uint16_t, int32_t
 
 namespace boken {
@@ -209,6 +213,10 @@ struct level_data_t {
 
 class level_impl;
 
+//! the width and height of the chunks of tiles by which entities are indexed;
+//! see level_impl::for_each_entity_in_
+constexpr int32_t entity_chunk_size = 16;
+
 //! adapt level's interface to what the a_star_pather expects
 class level_adapter {
 public:
@@ -307,12 +315,19 @@ public:
 
     placement_result move_by(entity_instance_id const id, vec2i32 const v) noexcept final override {
         auto result = placement_result::failed_bad_id;
+        auto from   = point2i32 {};
+
         entities_.move_to_if(id, [&](entity_instance_id, point2i16 const p) noexcept {
             auto const q = underlying_cast_unsafe<int16_t>(p + v);
             result = can_place_entity_at(q);
+            from   = underlying_cast_unsafe<int32_t>(p);
             return std::make_pair(q, result == placement_result::ok);
         });
 
+        if (result == placement_result::ok) {
+            on_entity_moved_(id, from, from + v);
+        }
+
         return result;
     }
 
@@ -341,6 +356,358 @@ public:
         }
     }
 
+    void schedule_entity(entity_instance_id const id, int32_t const delay) final override {
+        BK_ASSERT(!!entities_.find(id).first && delay >= 0);
+        dormant_.erase(id);
+        scheduler_.schedule(id, static_cast<uint64_t>(delay));
+    }
+
+    scheduler_stats schedule_stats() const noexcept final override {
+        return scheduler_.stats();
+    }
+
+    activity_stats update_activity(point2i32 const p, int32_t const radius) final override {
+        BK_ASSERT(radius >= 0);
+
+        auto const now = scheduler_.now();
+
+        // nothing can change unless the area changed, an entity woken by
+        // wake_entities_near is due to go dormant again, or an entity has
+        // moved out of (or into) the area by itself.
+        auto const has_expired  = !awake_heap_.empty()
+                               && awake_heap_.front().first <= now;
+        auto const area_changed = activity_radius_ != radius
+                               || activity_center_ != p;
+
+        if (!area_changed && !has_expired && strays_.empty()) {
+            return activity();
+        }
+
+        while (!awake_heap_.empty() && awake_heap_.front().first <= now) {
+            auto const e = awake_heap_.front();
+            std::pop_heap(begin(awake_heap_), end(awake_heap_), awake_later_);
+            awake_heap_.pop_back();
+
+            // the entry is stale if the entity has since been woken again, or
+            // forgotten
+            auto const it = awake_until_.find(e.second);
+            if (it != end(awake_until_) && it->second == e.first) {
+                awake_until_.erase(it);
+            }
+        }
+
+        if (area_changed) {
+            move_activity_area_(p, radius);
+        }
+
+        // entities which have moved out of the area, or into it, by themselves;
+        // those still awake are kept until they may sleep again.
+        auto const last = std::remove_if(begin(strays_), end(strays_)
+          , [&](entity_position const e) {
+                if (!has_entity_at_(e)) {
+                    return true; // it has moved since; see the later entry
+                }
+
+                if (is_active_at_(e.first)) {
+                    wake_(e.second);
+                    return true;
+                }
+
+                if (awake_until_.count(e.second)) {
+                    return false;
+                }
+
+                sleep_(e.second);
+                return true;
+            });
+
+        strays_.erase(last, end(strays_));
+
+        return activity();
+    }
+
+    size_t wake_entities_near(
+        point2i32 const p
+      , int32_t   const radius
+      , int32_t   const ticks
+    ) final override {
+        BK_ASSERT(radius > 0 && ticks >= 0);
+
+        if (dormant_.empty()) {
+            return 0;
+        }
+
+        auto const until = scheduler_.now() + static_cast<uint64_t>(ticks);
+
+        size_t result = 0;
+        for_each_entity_in_(grow_rect(recti32 {p, p}, radius), [&](entity_position const e) {
+            auto const id = e.second;
+            if (!wake_(id)) {
+                return;
+            }
+
+            awake_until_[id] = until;
+            awake_heap_.push_back({until, id});
+            std::push_heap(begin(awake_heap_), end(awake_heap_), awake_later_);
+
+            // so that it is put back to sleep once its time is up
+            strays_.push_back(e);
+
+            ++result;
+        });
+
+        return result;
+    }
+
+    void simulate_coarse(random_state& rng, int32_t const moves) final override {
+        BK_ASSERT(moves >= 0);
+
+        if (moves == 0 || entities_.size() == 0) {
+            return;
+        }
+
+        // each step of a random dir8 walk moves -1, 0, or +1 along each axis
+        // with probabilities 3/8, 2/8, 3/8: a variance of 3/4 per step. Note
+        // that random_normal forwards its last parameter to the distribution
+        // as the standard deviation.
+        auto const sigma = std::sqrt(0.75 * moves);
+
+        auto const values = entities_.values_range();
+        coarse_ids_.assign(values.first, values.second);
+
+        auto const x1 = value_cast(bounds_.x1) - 1;
+        auto const y1 = value_cast(bounds_.y1) - 1;
+
+        for (auto const id : coarse_ids_) {
+            auto const p = underlying_cast_unsafe<int32_t>(entities_.find(id).second);
+
+            auto const dx = static_cast<int32_t>(std::lround(random_normal(rng, 0.0, sigma)));
+            auto const dy = static_cast<int32_t>(std::lround(random_normal(rng, 0.0, sigma)));
+
+            auto const q = point2i32 {clamp(value_cast(p.x) + dx, 0, x1)
+                                    , clamp(value_cast(p.y) + dy, 0, y1)};
+
+            if (q == p) {
+                continue;
+            }
+
+            constexpr int32_t max_placement_distance = 3;
+
+            auto const where = find_valid_entity_placement_neareast(
+                rng, q, max_placement_distance);
+
+            if (where.second != placement_result::ok || where.first == p) {
+                continue;
+            }
+
+            // the entity stays put rather than pass through walls
+            auto const v = abs(q - p);
+            auto const r = std::max(value_cast(v.x), value_cast(v.y))
+                         + max_placement_distance;
+
+            if (is_reachable_within_(p, where.first, r)) {
+                move_by(id, where.first - p);
+            }
+        }
+    }
+
+    //! Whether @p to can be walked to from @p from without leaving the square
+    //! of radius @p r centered on @p from. Entities are ignored; they would
+    //! have moved too.
+    bool is_reachable_within_(point2i32 const from, point2i32 const to, int32_t const r) {
+        auto const fx = value_cast(from.x);
+        auto const fy = value_cast(from.y);
+
+        auto const in_square = [=](point2i32 const q) noexcept {
+            return std::abs(value_cast(q.x) - fx) <= r
+                && std::abs(value_cast(q.y) - fy) <= r;
+        };
+
+        if (!in_square(to)) {
+            return false;
+        }
+
+        auto const size  = 2 * r + 1;
+        auto const index = [=](point2i32 const q) noexcept {
+            return static_cast<size_t>(
+                (value_cast(q.x) - fx + r) + (value_cast(q.y) - fy + r) * size);
+        };
+
+        coarse_seen_.assign(static_cast<size_t>(size * size), 0);
+        coarse_open_.clear();
+
+        coarse_open_.push_back(from);
+        coarse_seen_[index(from)] = 1;
+
+        auto const graph = level_adapter {*this};
+
+        // breadth first, so the square is searched outward from the middle
+        for (size_t i = 0; i < coarse_open_.size(); ++i) {
+            auto const p = coarse_open_[i];
+            if (p == to) {
+                return true;
+            }
+
+            for_each_neighbor8_if(graph, p
+              , [&](point2i32 const q) noexcept {
+                    return in_square(q) && !coarse_seen_[index(q)]; }
+              , [&](point2i32 const q) {
+                    coarse_seen_[index(q)] = 1;
+                    coarse_open_.push_back(q);
+                });
+        }
+
+        return false;
+    }
+
+    diffusion_field const& get_field(field const f) const noexcept final override {
+        return fields_[static_cast<size_t>(f)];
+    }
+
+    void add_to_field(field const f, point2i32 const p, float const amount) noexcept final override {
+        fields_[static_cast<size_t>(f)].add(p, amount);
+    }
+
+    void update_fields(int32_t const turns) noexcept final override {
+        BK_ASSERT(turns >= 0);
+
+        // {rate, decay} per turn for each field
+        constexpr float params[field_count][2] = {
+            {0.20f, 0.98f} // scent
+          , {0.24f, 0.70f} // noise
+        };
+
+        if (passable_dirty_) {
+            for (auto y = 0; y < value_cast(height()); ++y) {
+                for (auto x = 0; x < value_cast(width()); ++x) {
+                    auto const p = point2i32 {x, y};
+                    passable_.set(p, data_at_(data_.flags, p).test(tile_flag::solid)
+                                       ? 0.0f : 1.0f);
+                }
+            }
+
+            passable_dirty_ = false;
+        }
+
+        for (size_t i = 0; i < field_count; ++i) {
+            for (int32_t t = 0; t < turns; ++t) {
+                fields_[i].update(passable_, params[i][0], params[i][1]);
+            }
+        }
+    }
+
+    activity_stats activity() const noexcept final override {
+        auto const n = static_cast<uint32_t>(entities_.size());
+        auto const d = static_cast<uint32_t>(dormant_.size());
+        return {n - d, d};
+    }
+
+    scheduler_stats tick_entities(
+        context              const  ctx
+      , int32_t              const  ticks
+      , intent_f             const& intent
+      , transform_callback_f const& callback
+      , parallel_for_f       const& parallel_for
+    ) final override {
+        begin_tick(ticks);
+        continue_tick(ctx, pending_tick(), intent, callback, parallel_for);
+        return scheduler_.stats();
+    }
+
+    size_t begin_tick(int32_t const ticks) final override {
+        BK_ASSERT(ticks >= 0 && pending_tick() == 0);
+
+        due_.clear();
+        due_next_ = 0;
+        scheduler_.take_due(static_cast<uint64_t>(ticks), due_);
+
+        return due_.size();
+    }
+
+    size_t pending_tick() const noexcept final override {
+        return due_.size() - due_next_;
+    }
+
+    size_t continue_tick(
+        context              const  ctx
+      , size_t               const  max
+      , intent_f             const& intent
+      , transform_callback_f const& callback
+      , parallel_for_f       const& parallel_for
+    ) final override {
+        auto const first_due = due_next_;
+        auto const last_due  = first_due + std::min(max, pending_tick());
+
+        due_next_ = last_due;
+
+        // phase one: decide what to do
+        intents_.clear();
+        intents_.reserve(last_due - first_due);
+        intent_due_.clear();
+
+        for (auto i = first_due; i < last_due; ++i) {
+            // a previous slice may have removed the entity
+            auto const found = entities_.find(due_[i].first);
+            if (!found.first) {
+                continue;
+            }
+
+            auto const p = underlying_cast_unsafe<int32_t>(found.second);
+            intents_.push_back({due_[i].first, p, p, 0});
+            intent_due_.push_back(due_[i].second);
+        }
+
+        // the ranges depend only on the number of intents so that the result
+        // doesn't depend on how, or on how many threads, they are evaluated.
+        constexpr size_t chunk_size = 64;
+
+        auto const n      = intents_.size();
+        auto const chunks = (n + chunk_size - 1) / chunk_size;
+
+        auto const run_chunk = [&](size_t const i) {
+            auto const first = intents_.data() + i * chunk_size;
+            auto const last  = intents_.data() + std::min(n, (i + 1) * chunk_size);
+            intent(first, last);
+        };
+
+        if (parallel_for && chunks > 1) {
+            parallel_for(chunks, run_chunk);
+        } else {
+            for (size_t i = 0; i < chunks; ++i) {
+                run_chunk(i);
+            }
+        }
+
+        // phase two: resolve and apply the intents in the order they came due
+        for (size_t i = 0; i < n; ++i) {
+            auto const& it = intents_[i];
+
+            // a callback may have removed the entity in the meantime
+            if (!entities_.find(it.id).first) {
+                continue;
+            }
+
+            if (it.delay > 0) {
+                scheduler_.schedule_at(it.id
+                  , intent_due_[i] + static_cast<uint64_t>(it.delay));
+            }
+
+            if (it.to == it.from) {
+                continue;
+            }
+
+            callback(entity_descriptor {ctx, it.id}
+                   , move_by(it.id, it.to - it.from), it.from, it.to);
+        }
+
+        if (pending_tick() == 0) {
+            due_.clear();
+            due_next_ = 0;
+        }
+
+        return pending_tick();
+    }
+
     item_instance_id add_object_at(unique_item&& i, point2i32 const p) final override {
         auto const result = i.get();
 
@@ -379,23 +746,275 @@ public:
         auto const insert_result = entities_.insert(q, e.release());
         BK_ASSERT(insert_result.second);
 
+        entity_chunks_[entity_chunk_(p)].push_back({p, result});
+
+        if (is_active_at_(p)) {
+            scheduler_.schedule(result, 0);
+        } else {
+            dormant_.insert(result);
+        }
+
         return result;
     }
 
     unique_entity remove_entity_at(point2i32 const p) noexcept final override {
         BK_ASSERT(!!entity_deleter_);
         auto const result = entities_.erase(underlying_cast_unsafe<int16_t>(p));
+        if (result.second) {
+            forget_entity_({p, result.first});
+        }
+
         return result.second
           ? unique_entity {result.first, *entity_deleter_}
           : unique_entity {entity_instance_id {}, *entity_deleter_};
     }
 
     unique_entity remove_entity(entity_instance_id const id) noexcept final override {
+        auto const found = entities_.find(id);
+        if (found.first) {
+            forget_entity_({underlying_cast_unsafe<int32_t>(found.second), id});
+        }
+
         return entities_.erase(id).second
           ? unique_entity {id, *entity_deleter_}
           : unique_entity {entity_instance_id {}, *entity_deleter_};
     }
 
+    //! Whether an entity at @p p should be active given the current activity
+    //! area.
+    bool is_active_at_(point2i32 const p) const noexcept {
+        if (activity_radius_ < 0) {
+            return true;
+        }
+
+        auto const v = p - activity_center_;
+        if (std::max(std::abs(value_cast(v.x)), std::abs(value_cast(v.y)))
+              <= activity_radius_
+        ) {
+            return true;
+        }
+
+        auto const rid = static_cast<size_t>(value_cast(data_at_(data_.region_ids, p)));
+        return rid < near_regions_.size() && near_regions_[rid];
+    }
+
+    void forget_entity_(entity_position const e) noexcept {
+        auto const id = e.second;
+
+        scheduler_.unschedule(id);
+        dormant_.erase(id);
+        awake_until_.erase(id);
+
+        auto& chunk = entity_chunks_[entity_chunk_(e.first)];
+        auto const it = std::find(begin(chunk), end(chunk), e);
+        BK_ASSERT(it != end(chunk));
+
+        *it = chunk.back();
+        chunk.pop_back();
+    }
+
+    //! Make the dormant entity @p id active.
+    //! @returns false if @p id wasn't dormant; nothing is done.
+    bool wake_(entity_instance_id const id) {
+        if (!dormant_.erase(id)) {
+            return false;
+        }
+
+        scheduler_.schedule(id, 0);
+        return true;
+    }
+
+    //! Make the active entity @p id dormant.
+    //! @returns false if @p id was already dormant; nothing is done.
+    bool sleep_(entity_instance_id const id) {
+        if (!dormant_.insert(id).second) {
+            return false;
+        }
+
+        scheduler_.unschedule(id);
+        return true;
+    }
+
+    static bool awake_later_(
+        std::pair<uint64_t, entity_instance_id> const& a
+      , std::pair<uint64_t, entity_instance_id> const& b
+    ) noexcept {
+        return a.first > b.first;
+    }
+
+    //! The square part of the activity area.
+    recti32 activity_square_() const noexcept {
+        auto const v = vec2i32 {activity_radius_, activity_radius_};
+        return {activity_center_ - v, activity_center_ + v + vec2i32 {1, 1}};
+    }
+
+    //! Move the activity area to be centered on @p p with @p radius. Only the
+    //! entities within the old area, and those within the new one, are looked
+    //! at; the rest can't have changed.
+    void move_activity_area_(point2i32 const p, int32_t const radius) {
+        auto const everywhere = activity_radius_ < 0;
+        auto const old_square = activity_square_();
+
+        old_near_bounds_.swap(near_bounds_);
+
+        activity_center_ = p;
+        activity_radius_ = radius;
+
+        // the region containing p and those adjacent to it
+        near_regions_.clear();
+        near_bounds_.clear();
+
+        auto const& extents = get_region_extents_();
+        auto const  rid     = static_cast<size_t>(
+            value_cast(data_at_(data_.region_ids, p)));
+
+        for (auto const& r : regions_) {
+            if (static_cast<size_t>(r.id) != rid) {
+                continue;
+            }
+
+            auto const area = grow_rect(r.bounds);
+            for (auto const& r0 : regions_) {
+                if (!intersects(area, r0.bounds)) {
+                    continue;
+                }
+
+                auto const i = static_cast<size_t>(r0.id);
+                near_regions_.resize(std::max(near_regions_.size(), i + 1), false);
+                near_regions_[i] = true;
+
+                if (i < extents.size()) {
+                    near_bounds_.push_back(extents[i]);
+                }
+            }
+
+            break;
+        }
+
+        auto const leave = [&](entity_position const e) {
+            if (!is_active_at_(e.first) && !awake_until_.count(e.second)) {
+                sleep_(e.second);
+            }
+        };
+
+        if (everywhere) {
+            for_each_entity_in_(bounds_, leave);
+        } else {
+            for_each_entity_in_(old_square, leave);
+            for (auto const& r : old_near_bounds_) {
+                for_each_entity_in_(r, leave);
+            }
+        }
+
+        auto const enter = [&](entity_position const e) {
+            if (is_active_at_(e.first)) {
+                wake_(e.second);
+            }
+        };
+
+        for_each_entity_in_(activity_square_(), enter);
+        for (auto const& r : near_bounds_) {
+            for_each_entity_in_(r, enter);
+        }
+    }
+
+    //! The bounds of the tiles of each region, indexed by region id. These
+    //! aren't region_info::bounds as tunnels take the id of the region they
+    //! were dug from.
+    std::vector<recti32> const& get_region_extents_() {
+        if (!region_extents_.empty()) {
+            return region_extents_;
+        }
+
+        auto const w = value_cast(width());
+        auto const h = value_cast(height());
+
+        for (auto y = 0; y < h; ++y) {
+            for (auto x = 0; x < w; ++x) {
+                auto const q = point2i32 {x, y};
+                auto const i = static_cast<size_t>(
+                    value_cast(data_at_(data_.region_ids, q)));
+
+                if (i >= region_extents_.size()) {
+                    region_extents_.resize(i + 1, recti32 {});
+                }
+
+                auto& r = region_extents_[i];
+                if (value_cast(r.area()) == 0) {
+                    r = recti32 {q, sizei32x {1}, sizei32y {1}};
+                } else {
+                    r.x0 = std::min(r.x0, offi32x {x});
+                    r.y0 = std::min(r.y0, offi32y {y});
+                    r.x1 = std::max(r.x1, offi32x {x + 1});
+                    r.y1 = std::max(r.y1, offi32y {y + 1});
+                }
+            }
+        }
+
+        return region_extents_;
+    }
+
+    size_t entity_chunk_(point2i32 const p) const noexcept {
+        return static_cast<size_t>(value_cast(p.x) / entity_chunk_size
+                                 + value_cast(p.y) / entity_chunk_size * entity_chunks_w_);
+    }
+
+    //! Call @p f for each entity within @p area, by way of the chunks it
+    //! touches rather than every entity on the level; stops early if @p f
+    //! returns false.
+    template <typename F>
+    void for_each_entity_in_(recti32 const area, F&& f) const {
+        auto const r = clamp(area, bounds_);
+        if (value_cast(r.area()) <= 0) {
+            return;
+        }
+
+        auto const g = void_as_bool<true>(f);
+
+        auto const cx0 = value_cast(r.x0) / entity_chunk_size;
+        auto const cy0 = value_cast(r.y0) / entity_chunk_size;
+        auto const cx1 = (value_cast(r.x1) - 1) / entity_chunk_size;
+        auto const cy1 = (value_cast(r.y1) - 1) / entity_chunk_size;
+
+        for (auto cy = cy0; cy <= cy1; ++cy) {
+            for (auto cx = cx0; cx <= cx1; ++cx) {
+                auto const& chunk = entity_chunks_[
+                    static_cast<size_t>(cx + cy * entity_chunks_w_)];
+
+                for (auto const& e : chunk) {
+                    if (intersects(r, e.first) && !g(e)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    bool has_entity_at_(entity_position const e) const noexcept {
+        auto const& chunk = entity_chunks_[entity_chunk_(e.first)];
+        return std::find(begin(chunk), end(chunk), e) != end(chunk);
+    }
+
+    void on_entity_moved_(entity_instance_id const id, point2i32 const p, point2i32 const q) noexcept {
+        auto& from = entity_chunks_[entity_chunk_(p)];
+        auto const it = std::find(begin(from), end(from), entity_position {p, id});
+        BK_ASSERT(it != end(from));
+
+        auto& to = entity_chunks_[entity_chunk_(q)];
+        if (&from == &to) {
+            it->first = q;
+        } else {
+            *it = from.back();
+            from.pop_back();
+            to.push_back({q, id});
+        }
+
+        // moves within the area change nothing; see update_activity
+        if (!is_active_at_(q) || !is_active_at_(p)) {
+            strays_.push_back({q, id});
+        }
+    }
+
     template <typename Predicate>
     std::pair<point2i32, placement_result> find_valid_placement_neareast_(
         random_state&   rng
@@ -570,11 +1189,7 @@ public:
       , F&&             f
     ) const {
         BK_ASSERT(distance > 0);
-        auto const g = void_as_bool<true>(f);
-        auto const r = grow_rect(recti32 {p, p}, distance);
-        for_each_object_impl_(entities_, [&](entity_instance_id const id, point2i32 const p0) {
-            return !intersects(r, p0) || g(entity_position {p0, id});
-        });
+        for_each_entity_in_(grow_rect(recti32 {p, p}, distance), f);
     }
 
     unique_entity with_entity_at(
@@ -676,6 +1291,16 @@ public:
         return last_path_;
     }
 
+    void copy_passable(std::vector<uint8_t>& out) const final override {
+        auto const& flags = data_.flags;
+
+        out.resize(flags.size());
+        std::transform(begin(flags), end(flags), begin(out)
+          , [](tile_flags const f) noexcept {
+                return static_cast<uint8_t>(f.test(tile_flag::solid) ? 0 : 1);
+            });
+    }
+
     bool has_line_of_sight(point2i32 const from, point2i32 const to) const final override {
         bool result = true;
 
@@ -787,6 +1412,44 @@ private:
     spatial_map<entity_instance_id, identity,      int16_t> entities_;
     spatial_map<item_pile,          first_in_pile, int16_t> items_;
 
+    actor_scheduler<entity_instance_id, identity_hash> scheduler_;
+
+    // every entity with its position, by the chunk of the level it is in
+    std::vector<std::vector<entity_position>> entity_chunks_;
+    int32_t entity_chunks_w_ {0};
+
+    // entities outside of the activity area; see update_activity
+    std::unordered_set<entity_instance_id, identity_hash> dormant_;
+    // entities woken by wake_entities_near and the time they may sleep again
+    std::unordered_map<entity_instance_id, uint64_t, identity_hash> awake_until_;
+    // awake_until_ as a min-heap on time; entries which no longer match
+    // awake_until_ are dropped when they reach the top
+    std::vector<std::pair<uint64_t, entity_instance_id>> awake_heap_;
+    // entities which have moved out of (or into) the activity area, or were
+    // woken outside of it, since the last update_activity
+    std::vector<entity_position> strays_;
+    // indexed by region id; whether the region is adjacent to the center
+    std::vector<bool> near_regions_;
+    // the extents of the regions in near_regions_, now and before the last move
+    std::vector<recti32> near_bounds_;
+    std::vector<recti32> old_near_bounds_;
+    // see get_region_extents_(); empty until needed
+    std::vector<recti32> region_extents_;
+
+    point2i32 activity_center_ {0, 0};
+    int32_t   activity_radius_ {-1}; // everything is active until set
+
+    // buffers reused by simulate_coarse
+    std::vector<entity_instance_id> coarse_ids_;
+    std::vector<uint8_t>            coarse_seen_;
+    std::vector<point2i32>          coarse_open_;
+
+    // buffers reused by tick_entities
+    std::vector<std::pair<entity_instance_id, uint64_t>> due_;
+    std::vector<entity_intent>                           intents_;
+    std::vector<uint64_t>                                intent_due_;
+    size_t                                               due_next_ = 0;
+
     item_deleter   const* item_deleter_   {};
     entity_deleter const* entity_deleter_ {};
 
@@ -803,6 +1466,12 @@ private:
     world& world_;
     size_t id_;
 
+    static constexpr size_t field_count = 2;
+    std::array<diffusion_field, field_count> fields_;
+    // 1 for tiles which aren't solid; rebuilt when the tiles change
+    diffusion_field passable_;
+    bool            passable_dirty_ = true;
+
     // logically const, but keeps a mutable buffer internally used across
     // invocations
     a_star_pather<level_adapter> mutable pather_;
@@ -896,25 +1565,33 @@ void level_adapter::for_each_neighbor_if(
   , Predicate pred
   , UnaryF f
 ) const noexcept {
-    using v = vec2<int>;
-    constexpr std::array<v, 8> dir {
-        v {-1, -1}, v { 0, -1}, v { 1, -1}
-      , v {-1,  0},             v { 1,  0}
-      , v {-1,  1}, v { 0,  1}, v { 1,  1}
-    };
-
-    for (auto const& d : dir) {
-        point const p0 = p + d;
-        if (is_in_bounds(p0) && pred(p0) && is_passable(p0)) {
-            f(p0);
-        }
-    }
+    for_each_neighbor8_if(*this, p, pred, f);
 }
 
 int32_t level_adapter::width()  const noexcept { return value_cast(lvl_.width()); }
 int32_t level_adapter::height() const noexcept { return value_cast(lvl_.height()); }
 int32_t level_adapter::size()   const noexcept { return width() * height(); }
 
+//===------------------------------------------------------------------------===
+// level_walk_graph
+//===------------------------------------------------------------------------===
+
+level_walk_graph::level_walk_graph(level const& lvl, point const self) noexcept
+  : lvl_    {lvl}
+  , bounds_ {lvl.bounds()}
+  , self_   {self}
+{
+}
+
+bool level_walk_graph::is_passable(point const p) const noexcept {
+    return p == self_
+        || lvl_.can_place_entity_at(p) == placement_result::ok;
+}
+
+bool level_walk_graph::is_in_bounds(point const p) const noexcept {
+    return intersects(bounds_, p);
+}
+
 //===------------------------------------------------------------------------===
 
 tile_view level_impl::at(point2i32 const p) const noexcept {
@@ -954,6 +1631,8 @@ level_impl::level_impl(random_state& rng, world& w, sizei32x const width, sizei3
   , data_     {width, height}
   , world_    {w}
   , id_       {id}
+  , fields_   {{diffusion_field {width, height}, diffusion_field {width, height}}}
+  , passable_ {width, height}
 {
     bsp_generator::param_t p;
     p.width  = sizei32x {width};
@@ -961,6 +1640,10 @@ level_impl::level_impl(random_state& rng, world& w, sizei32x const width, sizei3
     p.min_room_size = sizei32 {3};
     p.room_chance_num = sizei32 {80};
 
+    entity_chunks_w_ = (value_cast(width) + entity_chunk_size - 1) / entity_chunk_size;
+    entity_chunks_.resize(static_cast<size_t>(entity_chunks_w_
+        * ((value_cast(height) + entity_chunk_size - 1) / entity_chunk_size)));
+
     bsp_gen_ = make_bsp_generator(p);
     generate(rng);
 }
@@ -1345,6 +2028,8 @@ void level_impl::generate(random_state& rng) {
     auto&       bsp = *bsp_gen_;
     auto const& p   = bsp.params();
 
+    region_extents_.clear();
+
     // generate a bsp-based layout, populate regions_ with the result, and
     // return the min and max region areas generated.
     auto const generate_regions = [&] {
@@ -1462,6 +2147,7 @@ level_impl::update_tile_rect(
     copy_region(data, &tile_data_set::id,    area, data_.ids);
     copy_region(data, &tile_data_set::type,  area, data_.types);
     copy_region(data, &tile_data_set::flags, area, data_.flags);
+    passable_dirty_ = true;
 
     auto update_area = grow_rect(area);
     update_area.x0 = std::max(update_area.x0, bounds_.x0);
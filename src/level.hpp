@@ -5,6 +5,8 @@
 #include "utility.hpp"
 #include "context.hpp"
 #include "maybe.hpp"
+#include "scheduler.hpp"
+#include "graph.hpp"
 
 #include <memory>
 #include <utility>
@@ -26,6 +28,7 @@ template <typename> class flag_set;
 using tile_flags = flag_set<detail::tag_tile_flags>;
 
 class string_buffer_base;
+class diffusion_field;
 class item_pile;
 class random_state;
 struct tile_data;
@@ -156,6 +159,11 @@ public:
     //! @note not thread safe
     virtual std::vector<point2i32> const& find_path(point2i32 from, point2i32 to) const = 0;
 
+    //! Fill @p out, row by row, with 1 for each tile which can be walked
+    //! through and 0 for each which can't; i.e. a copy of what find_path
+    //! searches which can be used from another thread.
+    virtual void copy_passable(std::vector<uint8_t>& out) const = 0;
+
     virtual bool has_line_of_sight(point2i32 from, point2i32 to) const = 0;
 
     template <typename T>
@@ -166,7 +174,8 @@ public:
 
     using entity_position = object_position<entity_instance_id>;
 
-    // O(n) where n is the total number of entities on the level
+    // O(n) where n is the number of entities in the chunks of the level
+    // within distance of p
     virtual const_range<entity_position>
         entities_near(point2i32 p, int32_t distance) const = 0;
 
@@ -188,6 +197,111 @@ public:
     virtual void transform_entities(
         transform_f tranform, transform_callback_f callback) = 0;
 
+    //! Schedule the entity @p id to act @p delay ticks from now; this is also
+    //! how a sleeping (or dormant) entity is woken.
+    //! @pre @p id is on the level.
+    virtual void schedule_entity(entity_instance_id id, int32_t delay) = 0;
+
+    virtual scheduler_stats schedule_stats() const noexcept = 0;
+
+    struct activity_stats {
+        uint32_t active;  //!< entities taking turns (or sleeping by choice)
+        uint32_t dormant; //!< entities skipped until woken
+    };
+
+    //! Make entities dormant, or wake them, based on their proximity to @p p.
+    //! Entities within @p radius (Chebyshev distance) of @p p, or in the same
+    //! or an adjacent region to @p p, are active; all others are dormant.
+    //! Dormant entities are removed from the schedule and cost nothing until
+    //! they are woken. Entities added to the level afterward are classified
+    //! the same way.
+    virtual activity_stats update_activity(point2i32 p, int32_t radius) = 0;
+
+    //! Wake any dormant entities within @p radius of @p p, e.g. in response to
+    //! a noise. The entities stay active for at least @p ticks regardless of
+    //! where the activity center is.
+    //! @returns The number of entities woken.
+    virtual size_t wake_entities_near(point2i32 p, int32_t radius, int32_t ticks) = 0;
+
+    virtual activity_stats activity() const noexcept = 0;
+
+    //! Coarsely approximate every entity on the level wandering @p moves random
+    //! steps by a single displacement drawn from the distribution of such a
+    //! walk. Used in place of a full simulation for levels the player isn't
+    //! on; the result is reconciled (by update_activity) when the level next
+    //! becomes current.
+    //! @note Only touches this level, so it is safe to call from a worker
+    //!       thread while no other thread accesses the level.
+    virtual void simulate_coarse(random_state& rng, int32_t moves) = 0;
+
+    //! The scalar fields kept for each level; see diffusion_field.
+    enum class field : uint32_t {
+        scent //!< left by the player; lingers and spreads slowly
+      , noise //!< made by fights; spreads quickly but soon fades
+    };
+
+    virtual diffusion_field const& get_field(field f) const noexcept = 0;
+
+    //! @pre @p p is within the bounds of the level.
+    virtual void add_to_field(field f, point2i32 p, float amount) noexcept = 0;
+
+    //! Spread and fade every field by @p turns turns. Solid tiles block the
+    //! fields.
+    virtual void update_fields(int32_t turns) noexcept = 0;
+
+    //! The action an entity intends to take, computed during the first phase
+    //! of tick_entities.
+    struct entity_intent {
+        entity_instance_id id;
+        point2i32          from;  //!< the position of the entity
+        point2i32          to;    //!< the desired position; from to stay put
+        int32_t            delay; //!< ticks until the next action; 0 to sleep
+    };
+
+    //! Compute the intents for the entities in [first, last); on entry id and
+    //! from are filled in and to == from, delay == 0.
+    //! @note Invoked concurrently for disjoint ranges while the level is not
+    //!       modified. It must only use const member functions of the level
+    //!       which don't reuse internal buffers (i.e. not entities_near or
+    //!       find_path).
+    using intent_f = std::function<void (entity_intent* first, entity_intent* last)>;
+
+    //! Invoke f(i) for each i in [0, n), possibly concurrently, and return
+    //! once all have completed.
+    using parallel_for_f = std::function<
+        void (size_t n, std::function<void (size_t)> const& f)>;
+
+    //! Advance the level's clock by @p ticks and act for only those entities
+    //! whose turn has come, in two phases. Entities are scheduled to act
+    //! immediately when they are added to the level. First the intents of
+    //! every entity whose turn has come are computed (in parallel via
+    //! @p parallel_for) against the unchanging level. The intents are then
+    //! resolved serially in the order the entities came due; when several
+    //! entities want the same tile the first to come due gets it. The
+    //! callback is invoked for each entity which tried to move.
+    //! @param parallel_for May be empty, in which case the intents are
+    //!        computed serially.
+    virtual scheduler_stats tick_entities(context ctx, int32_t ticks
+        , intent_f const& intent, transform_callback_f const& callback
+        , parallel_for_f const& parallel_for) = 0;
+
+    //! A resumable version of tick_entities: begin_tick advances the clock by
+    //! @p ticks and takes every entity whose turn has come; each call to
+    //! continue_tick then processes (in the same two phases) at most @p max of
+    //! those in the order they came due. Entities removed from the level in
+    //! between calls are skipped.
+    //! @pre No tick is pending when begin_tick is called.
+    //! @returns The number of entities still to be processed.
+    //!@{
+    virtual size_t begin_tick(int32_t ticks) = 0;
+    virtual size_t continue_tick(context ctx, size_t max
+        , intent_f const& intent, transform_callback_f const& callback
+        , parallel_for_f const& parallel_for) = 0;
+    //!@}
+
+    //! The number of entities taken by begin_tick still to be processed.
+    virtual size_t pending_tick() const noexcept = 0;
+
     //!@{
     //! Add an object at the position given by @p p.
     //! @returns The instance id of the object added.
@@ -265,6 +379,39 @@ std::unique_ptr<level>
 make_level(random_state& rng, world& w, sizei32x width, sizei32y height
          , size_t id);
 
+//! adapt a level to what the d_star_lite_pather expects: the tiles the player
+//! can step onto right now; i.e. neither solid nor occupied by another entity.
+class level_walk_graph {
+public:
+    using point = point2i32;
+
+    //! @param self The position of the player, which is always passable.
+    level_walk_graph(level const& lvl, point self) noexcept;
+
+    bool is_passable(point p) const noexcept;
+    bool is_in_bounds(point p) const noexcept;
+
+    int32_t cost(
+        point const // from
+      , point const // to
+    ) const noexcept {
+        return 1;
+    }
+
+    template <typename Predicate, typename UnaryF>
+    void for_each_neighbor_if(point const p, Predicate pred, UnaryF f) const noexcept {
+        for_each_neighbor8_if(*this, p, pred, f);
+    }
+
+    int32_t width()  const noexcept { return value_cast(bounds_.width()); }
+    int32_t height() const noexcept { return value_cast(bounds_.height()); }
+    int32_t size()   const noexcept { return width() * height(); }
+private:
+    level const& lvl_;
+    recti32      bounds_;
+    point        self_;
+};
+
 namespace detail {
 
 bool impl_can_add_item(
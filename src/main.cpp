@@ -1,21 +1,26 @@
 #include "algorithm.hpp"
 #include "allocator.hpp"
+#include "behavior.hpp"
 #include "catch.hpp"        // for run_unit_tests
 #include "command.hpp"
 #include "data.hpp"
+#include "diffusion.hpp"
 #include "entity.hpp"       // for entity
 #include "entity_properties.hpp"
 #include "events.hpp"
 #include "format.hpp"
+#include "graph.hpp"
 #include "hash.hpp"         // for djb2_hash_32
 #include "inventory.hpp"
 #include "item.hpp"
 #include "item_list.hpp"
 #include "item_properties.hpp"
+#include "job_system.hpp"
 #include "level.hpp"        // for level, placement_result, make_level, etc
 #include "math.hpp"         // for vec2i32, floor_as, point2f, basic_2_tuple, etc
 #include "message_log.hpp"  // for message_log
 #include "names.hpp"
+#include "path_service.hpp"
 #include "random.hpp"       // for random_state, make_random_state
 #include "random_algorithm.hpp"
 #include "rect.hpp"
@@ -30,6 +35,7 @@
 #include "world.hpp"        // for world, make_world
 
 #include <algorithm>        // for move
+#include <array>
 #include <chrono>           // for microseconds, operator-, duration, etc
 #include <deque>
 #include <functional>       // for function
@@ -134,6 +140,11 @@ struct game_state {
         }
     }
 
+    ~game_state() {
+        // background jobs refer to levels owned by the world
+        jobs.wait(background_jobs);
+    }
+
     void init_item_list() {
         using col_t = item_list_controller::column_type;
 
@@ -343,14 +354,33 @@ struct game_state {
 
         auto const has_los = lvl.has_line_of_sight(player_location(), p0);
 
+        auto const stats    = lvl.schedule_stats();
+        auto const activity = lvl.activity();
+        auto const frame    = renderer.frame_stats();
+        auto const frames   = renderer.frame_counts();
+
+        using ms_t = std::chrono::duration<double, std::milli>;
+
         auto const result =
             buffer.append(
                 "Position: %d, %d (%s)\n"
                 "Region  : %d\n"
                 "Tile    : %s\n"
+                "Actors  : %u activated / %u scheduled\n"
+                "          %u active / %u dormant\n"
+                "Turn    : %u frames / %u overruns\n"
+                "Render  : %u draws / %u tiles / %u changes in %.2f ms (%s)\n"
+                "Frames  : %" PRIu64 " drawn / %" PRIu64 " skipped\n"
               , value_cast(p0.x), value_cast(p0.y), (has_los ? "seen" : "unseen")
               , value_cast<int>(tile.rid)
-              , enum_to_string(lvl.at(p0).id).data())
+              , enum_to_string(lvl.at(p0).id).data()
+              , stats.activated, stats.scheduled
+              , activity.active, activity.dormant
+              , turn_frames_, turn_overruns_
+              , frame.counts.draw_calls, frame.counts.tiles, frame.counts.state_changes
+              , std::chrono::duration_cast<ms_t>(frame.time).count()
+              , (render_batching_ ? "batched" : "unbatched")
+              , frames.drawn, frames.skipped)
          && print_entity()
          && print_items();
 
@@ -430,6 +460,11 @@ struct game_state {
         auto const& container_def = *find(database, container_def_id);
         auto const& dagger_def    = *find(database, dagger_def_id);
 
+        // find all the locations first so that the items can be created in a
+        // single batch.
+        std::vector<point2i32> positions;
+        positions.reserve(lvl.region_count());
+
         for (size_t i = 0; i < lvl.region_count(); ++i) {
             auto const& region = lvl.region(i);
             if (region.tile_count <= 0) {
@@ -443,10 +478,25 @@ struct game_state {
                 continue;
             }
 
-            auto const p = result.first;
+            positions.push_back(result.first);
+        }
 
-            auto const container_id = create_object_at(container_def, {lvl, p}, rng);
-            create_object(dagger_def, container_id, rng);
+        auto const n = positions.size();
+
+        std::vector<unique_item> containers;
+        std::vector<unique_item> daggers;
+        boken::create_objects(database, the_world, container_def, rng, n, containers);
+        boken::create_objects(database, the_world, dagger_def,    rng, n, daggers);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto const p = positions[i];
+
+            auto const container_id =
+                lvl.add_object_at(std::move(containers[i]), p);
+
+            auto const itm = item_descriptor {ctx, daggers[i].get()};
+            auto const dst = item_descriptor {ctx, container_id};
+            merge_into_pile(ctx, std::move(daggers[i]), itm, dst);
 
             renderer_update_pile(p);
         }
@@ -755,6 +805,11 @@ struct game_state {
             r_map.update_map_data();
             break;
         case ct::debug_teleport_self : do_debug_teleport_self(); break;
+        case ct::debug_toggle_batching :
+            render_batching_ = renderer.set_batching(!render_batching_);
+            println(render_batching_ ? "Batched tile drawing."
+                                     : "Unbatched tile drawing.");
+            break;
 
         case ct::cancel    : do_cancel(); break;
         case ct::confirm   : break;
@@ -1361,14 +1416,39 @@ struct game_state {
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
     // Commands
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    //! Find a path from @p from to @p to in the background, then follow it.
+    //! A request still in progress is abandoned for the new one.
     void do_follow_path(point2i32 const from, point2i32 const to) {
-        auto const& path = current_level().find_path(from, to);
+        auto const& lvl = current_level();
+
+        paths.cancel(player_path_request_);
+        player_path_request_ = 0;
+
+        if (!intersects(lvl.bounds(), to)) {
+            return;
+        }
+
+        player_path_request_ = paths.request(lvl, from, to
+          , [=, &lvl](path_service::request_id, std::vector<point2i32> const& path) {
+                player_path_request_ = 0;
+
+                // the world has moved on since the request was made
+                if (&lvl != &current_level() || from != player_location()) {
+                    return;
+                }
+
+                on_path_found_(path);
+            });
+    }
+
+    void on_path_found_(std::vector<point2i32> const& path) {
         if (path.empty()) {
             println("You don't know how to get there from here.");
             return;
         }
 
         player_path_.assign(begin(path), end(path));
+        player_replan_level_ = nullptr;
 
         constexpr auto timer_name = djb2_hash_32c("do_follow_path timer");
 
@@ -1391,27 +1471,45 @@ struct game_state {
         using namespace std::chrono;
         constexpr auto delay = duration_cast<nanoseconds>(seconds {1}) / 100;
 
-        auto&      lvl  = current_level();
-        auto       p    = player_location();
-        auto       it   = begin(player_path_);
-        auto const last = end(player_path_);
+        auto&  lvl = current_level();
+        auto   p   = player_location();
+        size_t i   = 0;
 
-        BK_ASSERT(it != last && p == *it);
+        BK_ASSERT(p == player_path_.front());
 
         timers.add(timer_name, timer::duration {0}
           , [=, &lvl]
             (timer::duration, timer::timer_data) mutable -> timer::duration {
-                if (++it == last) {
+                // wait for the previous step to be complete
+                if (turn_level_) {
+                    return delay;
+                }
+
+                if (++i == player_path_.size()) {
                     context_stack.pop(context_id);
                     return timer::duration {};
                 }
 
-                auto const next_p = *it;
+                auto const next_p = player_path_[i];
 
                 // TODO: this could be "slow"
                 auto const player = player_descriptor();
 
                 auto const result = impl_player_move_by_(lvl, player, p, next_p - p);
+
+                // the way is blocked; try to find a way around
+                if (result == placement_result::failed_entity
+                 || result == placement_result::failed_obstacle
+                ) {
+                    if (!repair_player_path_(lvl, p, next_p)) {
+                        context_stack.pop(context_id);
+                        return timer::duration {};
+                    }
+
+                    i = 0;
+                    return delay;
+                }
+
                 if (result != placement_result::ok) {
                     context_stack.pop(context_id);
                     return timer::duration {};
@@ -1423,6 +1521,78 @@ struct game_state {
 
     }
 
+    //! Replace player_path_ with a path from @p p around @p blocked to the same
+    //! goal. The search is kept, so later repairs on the way to the same goal
+    //! only search again as much as the change requires.
+    //! @returns false if there is no longer a way to the goal.
+    bool repair_player_path_(level const& lvl, point2i32 const p, point2i32 const blocked) {
+        auto const goal  = player_path_.back();
+        auto const graph = level_walk_graph {lvl, p};
+
+        auto& pather = player_replanner_;
+
+        // the tiles occupied by entities other than the player, in order
+        auto const less = [](point2i32 const a, point2i32 const b) noexcept {
+            return std::make_pair(value_cast(a.y), value_cast(a.x))
+                 < std::make_pair(value_cast(b.y), value_cast(b.x));
+        };
+
+        std::vector<point2i32> occupied;
+        lvl.for_each_entity([&](entity_instance_id, point2i32 const q) {
+            if (q != p) {
+                occupied.push_back(q);
+            }
+        });
+
+        std::sort(begin(occupied), end(occupied), less);
+
+        bool ok      = false;
+        bool planned = false;
+
+        if (player_replan_level_ == &lvl && pather.goal() == goal) {
+            pather.move_to(p);
+
+            // the search saw the entities where they were last time; those
+            // which have since moved leave or block tiles besides this one.
+            std::vector<point2i32> changed;
+            std::set_symmetric_difference(
+                begin(player_replan_occupied_), end(player_replan_occupied_)
+              , begin(occupied), end(occupied)
+              , back_inserter(changed), less);
+
+            for (auto const q : changed) {
+                pather.update(graph, q);
+            }
+
+            pather.update(graph, blocked);
+            ok = pather.replan(graph);
+        } else {
+            ok = pather.plan(graph, p, goal);
+            planned = true;
+        }
+
+        // the level may have changed in ways the search can't know about
+        // (e.g. a door); start over before giving up.
+        if (!ok && !planned) {
+            ok = pather.plan(graph, p, goal);
+        }
+
+        player_replan_level_ = &lvl;
+        player_replan_occupied_.swap(occupied);
+
+        player_path_.clear();
+        if (ok) {
+            pather.copy_path(graph, back_inserter(player_path_));
+        }
+
+        if (player_path_.size() < 2) {
+            println("The way is blocked.");
+            return false;
+        }
+
+        return true;
+    }
+
     void do_view() {
         auto const p = player_location();
 
@@ -1879,6 +2049,11 @@ struct game_state {
             do_kill(lvl, def, def_pos);
         }
 
+        // fighting is noisy: it carries, and rouses anything close by
+        constexpr int32_t noise_radius = 8;
+        lvl.add_to_field(level::field::noise, def_pos, 4.0f);
+        lvl.wake_entities_near(def_pos, noise_radius, ticks_per_turn * 10);
+
         advance(1);
     }
 
@@ -1941,6 +2116,7 @@ struct game_state {
         if (!the_world.has_level(next_id)) {
             generate(next_id);
         } else {
+            catch_up_level(next_id);
             set_current_level(next_id, false);
         }
 
@@ -1991,6 +2167,11 @@ struct game_state {
         timers.add(timer_name, timer::duration {0}
           , [=, &lvl, count = 0]
             (timer::duration, timer::timer_data) mutable -> timer::duration {
+                // wait for the previous step to be complete
+                if (turn_level_) {
+                    return delay;
+                }
+
                 // TODO: this could be "slow"
                 auto const player = player_descriptor();
 
@@ -2196,54 +2377,291 @@ struct game_state {
         }
     }
 
-    //! Advance the game time by @p steps
+    //! Advance the current level by @p steps turns. Only entities whose turn
+    //! has come (per the level's scheduler) are processed; what each does is
+    //! decided in parallel and then applied serially.
+    //!
+    //! The entities are processed in slices for at most turn_budget(); anything
+    //! left over is continued by a timer over the following frames, with
+    //! player input locked until the turn is complete. A large turn thus
+    //! costs a few frames of latency rather than a frozen window.
     void advance(int const steps) {
+        auto const timer_name = djb2_hash_32c("turn timer");
+
+        // the previous turn must be complete before the next can begin
+        if (turn_level_) {
+            continue_turn_(timer::duration::max());
+            timers.remove(timer_name);
+        }
+
         turn_number += steps;
+        turn_steps_     = steps;
+        turn_player_    = player_id();
+        turn_player_p_  = player_location();
+        turn_level_     = &current_level();
+        turn_frames_    = 0;
+
+        // entities far from the player, and outside of the player's region and
+        // those adjacent to it, are dormant and aren't processed at all.
+        constexpr int32_t activity_radius = 20;
+        turn_level_->update_activity(turn_player_p_, activity_radius);
+
+        // the player leaves a trail for monsters to follow; there is little
+        // left of a field after this many turns, so there's no point in more.
+        constexpr int32_t max_field_turns = 50;
+        turn_level_->add_to_field(level::field::scent, turn_player_p_, 1.0f);
+        turn_level_->update_fields(std::min(steps, max_field_turns));
+
+        turn_level_->begin_tick(steps * ticks_per_turn);
+
+        if (continue_turn_(turn_budget())) {
+            return;
+        }
 
-        auto const player = player_id();
+        // continue the turn on each pass through the main loop until it is
+        // complete; the timer only exists while there is a turn to finish.
+        timers.add(timer_name, timer::duration {0}
+          , [&](timer::duration, timer::timer_data) {
+                return continue_turn_(turn_budget())
+                  ? timer::duration {}
+                  : timer::duration {1};
+            });
 
-        auto& lvl = current_level();
+        input_context c {"turn in progress"};
 
-        lvl.transform_entities(
-            [&](entity_instance_id const id, point2i32 const p) noexcept {
-                auto const e = entity_descriptor {ctx, id};
+        auto const lock = [](auto&&...) noexcept { return event_result::filter; };
+        c.on_key_handler          = lock;
+        c.on_text_input_handler   = lock;
+        c.on_mouse_button_handler = lock;
+        c.on_command_handler      = lock;
 
-                // don't allow the player to move in this fashion
-                if (id == player) {
-                    return std::make_pair(e, p);
-                }
+        turn_input_lock_ = context_stack.push(std::move(c));
+    }
 
-                // 9 out of 10 times, do nothing
-                if (random_chance_in_x(rng_superficial, 9, 10)) {
-                    return std::make_pair(e, p);
-                }
+    //! Process slices of the turn in progress until it is complete or
+    //! @p budget has been spent.
+    //! @returns true if the turn is complete.
+    bool continue_turn_(timer::duration const budget) {
+        BK_ASSERT(!!turn_level_);
 
-                // check for nearby entities
-                auto const range = lvl.entities_near(p, 5);
-                // and choose a random one to move toward
-                auto const it = random_value_in_range(
-                    rng_superficial, range.first, range.second);
+        // the number of entities processed between checks of the budget
+        constexpr size_t slice_size = 256;
 
-                // if there are no nearby entities, or the entity picked is
-                // this very entity, just choose a random direction to move.
-                if (it == range.second || it->second == id) {
-                    return std::make_pair(e, p + random_dir8(rng_superficial));
-                }
+        auto const intent = [&](level::entity_intent* const first
+                              , level::entity_intent* const last) {
+            decide_intents_(first, last);
+        };
 
-                // move toward a random nearby entity
-                return std::make_pair(e, p + signof(it->first - p));
+        auto const callback = [&](entity_descriptor const e
+                                , placement_result  const result
+                                , point2i32         const p_before
+                                , point2i32         const p_after
+        ) {
+            if (result != placement_result::ok) {
+                return;
             }
-          , [&](entity_descriptor const e
-              , placement_result  const result
-              , point2i32         const p_before
-              , point2i32         const p_after
-            ) {
-                if (result != placement_result::ok) {
-                    return;
-                }
 
-                r_map.move_object(p_before, p_after, e.obj.definition());
+            r_map.move_object(p_before, p_after, e.obj.definition());
+        };
+
+        auto const for_each = [&](size_t const n, std::function<void (size_t)> const& f) {
+            parallel_for(jobs, n, 1, [&](size_t const first, size_t const last) {
+                for (auto i = first; i < last; ++i) {
+                    f(i);
+                }
             });
+        };
+
+        auto const start = timer::clock_t::now();
+
+        ++turn_frames_;
+
+        while (turn_level_->continue_tick(ctx, slice_size, intent, callback, for_each)
+            && timer::clock_t::now() - start < budget) {
+        }
+
+        // a slice can't be interrupted, and finishing a turn early ignores the
+        // budget altogether; either way the frame is late.
+        if (timer::clock_t::now() - start > turn_budget()) {
+            ++turn_overruns_;
+        }
+
+        if (turn_level_->pending_tick()) {
+            return false;
+        }
+
+        turn_level_ = nullptr;
+
+        if (turn_input_lock_) {
+            context_stack.pop(turn_input_lock_);
+            turn_input_lock_ = 0;
+        }
+
+        advance_background_levels(turn_steps_);
+
+        return true;
+    }
+
+    //! Compute the intents for the entities in [first, last) of the turn in
+    //! progress (see level::intent_f).
+    void decide_intents_(level::entity_intent* const first
+                       , level::entity_intent* const last) {
+        // each range of intents gets its own random state seeded from its
+        // contents so that the result doesn't depend on the thread used.
+        auto const rng_ptr = make_random_state(
+            (static_cast<uint64_t>(turn_number) << 32) | value_cast(first->id));
+        auto& rng = *rng_ptr;
+
+        auto const distance = [](point2i32 const p, point2i32 const q) noexcept {
+            auto const v = q - p;
+            return std::max(std::abs(value_cast(v.x)), std::abs(value_cast(v.y)));
+        };
+
+        for (auto it = first; it != last; ++it) {
+            // don't allow the player to move in this fashion; the player
+            // acts in response to input and so is never scheduled.
+            if (it->id == turn_player_) {
+                continue;
+            }
+
+            auto const e = const_entity_descriptor {const_context {ctx}, it->id};
+
+            auto const* const program = e.def ? e.def->behavior : nullptr;
+            if (!program) {
+                it->delay = action_ticks(e) * wander_turns;
+                continue;
+            }
+
+            // gather only what the behavior actually looks at
+            behavior_inputs in;
+
+            if (program->uses_player()) {
+                in.player_distance = distance(it->from, turn_player_p_);
+            }
+
+            auto const& scent = turn_level_->get_field(level::field::scent);
+            auto const& noise = turn_level_->get_field(level::field::noise);
+
+            if (program->uses_scent()) {
+                in.scent = static_cast<int32_t>(scent.at(it->from) * 100.0f);
+            }
+
+            if (program->uses_noise()) {
+                in.noise = static_cast<int32_t>(noise.at(it->from) * 100.0f);
+            }
+
+            auto nearest = it->from;
+            if (auto const r = program->sense_radius()) {
+                turn_level_->for_each_entity_near(it->from, r
+                  , [&](level::entity_position const ep) {
+                        if (ep.second == it->id || ep.second == turn_player_) {
+                            return;
+                        }
+
+                        auto const d = distance(it->from, ep.first);
+                        if (d < in.other_distance) {
+                            in.other_distance = d;
+                            nearest = ep.first;
+                        }
+                    });
+            }
+
+            auto const decision = program->run(in, rng);
+
+            // idle entities are simply scheduled further out rather than
+            // visited each turn.
+            it->delay = action_ticks(e)
+                      * random_uniform_int(rng, 1, 2 * decision.turns - 1);
+
+            switch (decision.action) {
+            case behavior_action::wait:
+                break;
+            case behavior_action::wander:
+                it->to = it->from + random_dir8(rng);
+                break;
+            case behavior_action::approach_player:
+                it->to = it->from + signof(turn_player_p_ - it->from);
+                break;
+            case behavior_action::flee_player:
+                it->to = it->from - signof(turn_player_p_ - it->from);
+                break;
+            case behavior_action::approach_other:
+                it->to = it->from + signof(nearest - it->from);
+                break;
+            case behavior_action::follow_scent:
+                it->to = it->from + scent.gradient(it->from);
+                break;
+            case behavior_action::follow_noise:
+                it->to = it->from + noise.gradient(it->from);
+                break;
+            default:
+                BK_ASSERT(false);
+                break;
+            }
+        }
+    }
+
+    //! Levels other than the current one aren't simulated in full. Instead,
+    //! once a level has fallen coarse_turns behind, a job is queued to
+    //! approximate the time that has passed there (see level::simulate_coarse).
+    //! At most one level is queued per call, which bounds the background cost
+    //! per turn.
+    void advance_background_levels(int const steps) {
+        constexpr int32_t coarse_turns = 50;
+
+        // the previous job is almost certainly done by now
+        jobs.wait(background_jobs);
+
+        auto const current = current_level().id();
+        auto const n       = static_cast<size_t>(the_world.total_levels());
+
+        level_backlog.resize(std::max(level_backlog.size(), n), 0);
+
+        for (size_t i = 0; i < n; ++i) {
+            if (i != current) {
+                level_backlog[i] += steps;
+            }
+        }
+
+        for (size_t k = 0; k < n; ++k) {
+            auto const i = (next_background_level + k) % n;
+            if (i == current || level_backlog[i] < coarse_turns) {
+                continue;
+            }
+
+            auto* const lvl = the_world.find_level(i);
+            if (!lvl) {
+                continue;
+            }
+
+            auto const moves = level_backlog[i] / wander_turns;
+            auto const seed  = (static_cast<uint64_t>(turn_number) << 32) | i;
+
+            jobs.run(background_jobs, [lvl, moves, seed] {
+                auto const rng = make_random_state(seed);
+                lvl->simulate_coarse(*rng, moves);
+            }, djb2_hash_32c("coarse level"));
+
+            level_backlog[i]      = 0;
+            next_background_level = i + 1;
+            break;
+        }
+    }
+
+    //! Reconcile any time which has passed on the level @p id, but which
+    //! hasn't been simulated yet, before it becomes the current level.
+    void catch_up_level(size_t const id) {
+        jobs.wait(background_jobs);
+
+        if (id >= level_backlog.size() || level_backlog[id] <= 0) {
+            return;
+        }
+
+        if (auto* const lvl = the_world.find_level(id)) {
+            lvl->simulate_coarse(rng_superficial, level_backlog[id] / wander_turns);
+        }
+
+        level_backlog[id] = 0;
     }
 
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -2313,30 +2731,85 @@ struct game_state {
           , std::is_convertible<std::decay_t<T>, const_level_location> {});
     }
 
-    //! Render the game
-    void render(timepoint_t const last_frame) {
-        using namespace std::chrono;
+    //! The shortest time between frames.
+    static constexpr clock_t::duration frame_time() noexcept {
+        return std::chrono::duration_cast<clock_t::duration>(
+            std::chrono::seconds {1}) / 60;
+    }
 
-        constexpr auto frame_time =
-            duration_cast<nanoseconds>(seconds {1}) / 60;
+    //! Render the game if something might have changed (or is animating)
+    //! since the last frame, and a frame is due; the renderer itself skips
+    //! the frame if nothing it draws actually did.
+    void render(timepoint_t const last_frame) {
+        if (!needs_render && !renderer.is_animating()) {
+            return;
+        }
 
         auto const now   = clock_t::now();
         auto const delta = now - last_frame;
 
-        if (delta < frame_time) {
+        if (delta < frame_time()) {
             return;
         }
 
-        renderer.render(delta, current_view);
+        if (renderer.render(delta, current_view)) {
+            last_frame_time = now;
+        }
 
-        last_frame_time = now;
+        needs_render = false;
     }
 
-    //! The main game loop
+    //! How long the main loop can wait for input before there's something
+    //! else to do: a timer, a frame, or the results of a path search.
+    std::chrono::milliseconds idle_time() const noexcept {
+        using namespace std::chrono;
+
+        // an upper bound so that nothing waits on an event indefinitely
+        constexpr auto max_idle_time = milliseconds {500};
+
+        auto const now = clock_t::now();
+        auto deadline  = std::min(timers.next_deadline(), now + max_idle_time);
+
+        if (needs_render || renderer.is_animating()) {
+            deadline = std::min(deadline, last_frame_time + frame_time());
+        }
+
+        // path searches complete on other threads without an event to say so
+        if (paths.pending()) {
+            deadline = std::min(deadline, now + frame_time());
+        }
+
+        if (deadline <= now) {
+            return milliseconds {0};
+        }
+
+        // rounded up so as not to wake just before the deadline, only to wait
+        // again for less than a millisecond
+        return duration_cast<milliseconds>(
+            deadline - now + milliseconds {1} - clock_t::duration {1});
+    }
+
+    //! The main game loop; sleeps waiting for input until there is something
+    //! else to do, and only renders when something has changed.
+    //!
+    //! Every timer counts as work, and its deadline bounds the wait; timers
+    //! must therefore only exist while there is something for them to do,
+    //! such as a turn in progress or a path being followed. A timer which
+    //! merely polls would keep the loop from ever sleeping.
     void run() {
         while (os.is_running()) {
-            timers.update();
-            os.do_events();
+            if (timers.update() > 0) {
+                needs_render = true;
+            }
+
+            if (paths.poll() > 0) {
+                needs_render = true;
+            }
+
+            if (os.wait_events(idle_time()) > 0) {
+                needs_render = true;
+            }
+
             render(last_frame_time);
         }
     }
@@ -2353,6 +2826,8 @@ struct game_state {
         up<random_state>       rng_superficial_ptr = make_random_state();
         up<game_database>      database_ptr        = make_game_database();
         up<world>              world_ptr           = make_world();
+        up<job_system>         jobs_ptr            = make_job_system();
+        up<path_service>       paths_ptr           = make_path_service(*jobs_ptr);
         up<text_renderer>      trender_ptr         = make_text_renderer();
         up<game_renderer>      renderer_ptr        = make_game_renderer(*system_ptr, *trender_ptr);
         up<command_translator> cmd_translator_ptr  = make_command_translator();
@@ -2372,6 +2847,8 @@ struct game_state {
     random_state&       rng_superficial = *state.rng_superficial_ptr;
     game_database&      database        = *state.database_ptr;
     world&              the_world       = *state.world_ptr;
+    job_system&         jobs            = *state.jobs_ptr;
+    path_service&       paths           = *state.paths_ptr;
     game_renderer&      renderer        = *state.renderer_ptr;
     text_renderer&      trender         = *state.trender_ptr;
     command_translator& cmd_translator  = *state.cmd_translator_ptr;
@@ -2406,11 +2883,53 @@ struct game_state {
 
     point2i32 highlighted_tile {-1, -1};
 
-    std::vector<point2i32> player_path_;
+    std::vector<point2i32>   player_path_;
+    path_service::request_id player_path_request_ {}; //!< 0 if none
+
+    //! repairs player_path_ when the way becomes blocked; see
+    //! repair_player_path_
+    d_star_lite_pather<level_walk_graph> player_replanner_ {diagonal_heuristic()};
+    level const* player_replan_level_ {}; //!< the level of the last search
+
+    //! the tiles occupied by other entities at the time of the last search,
+    //! ordered by row then column
+    std::vector<point2i32> player_replan_occupied_;
 
     int32_t turn_number = 0;
 
+    //! the time spent processing a turn per frame; see advance
+    static constexpr timer::duration turn_budget() noexcept {
+        return std::chrono::duration_cast<timer::duration>(
+            std::chrono::milliseconds {8});
+    }
+
+    //! the turn in progress, if any
+    level*                    turn_level_      = nullptr;
+    int                       turn_steps_      = 0;
+    entity_instance_id        turn_player_     {};
+    point2i32                 turn_player_p_   {};
+    input_context_stack::id_t turn_input_lock_ = 0;
+    uint32_t                  turn_frames_     = 0; //!< frames spent on the last turn
+    uint32_t                  turn_overruns_   = 0; //!< frames over turn_budget
+
+    //! whether draw_tiles batches; toggled for comparison
+    bool render_batching_ = renderer.set_batching(true);
+
+    //! entities wander, on average, once every wander_turns turns (see the
+    //! behaviors in behaviors.dat); used to approximate other levels.
+    static constexpr int32_t wander_turns = 10;
+
+    //! turns passed on each level (by id) while it wasn't the current level
+    //! which haven't been simulated yet
+    std::vector<int32_t> level_backlog;
+    size_t               next_background_level = 0;
+    task_group           background_jobs;
+
     timepoint_t last_frame_time {};
+
+    //! input was handled, or a timer or path search completed, since the last
+    //! frame was rendered; each of these can change what is to be drawn.
+    bool needs_render = true;
 };
 
 } // namespace boken
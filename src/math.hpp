@@ -82,6 +82,15 @@ bool intersects(point2<U> const& p, axis_aligned_rect<T> const& r) noexcept {
     return intersects(r, p);
 }
 
+//! @returns true if the rectangles @p a and @p b share at least one point.
+template <typename T> inline constexpr
+bool intersects(axis_aligned_rect<T> const& a, axis_aligned_rect<T> const& b) noexcept {
+    return (a.x0 < b.x1)
+        && (b.x0 < a.x1)
+        && (a.y0 < b.y1)
+        && (b.y0 < a.y1);
+}
+
 template <typename T>
 inline constexpr T min_dimension(axis_aligned_rect<T> const r) noexcept {
     return std::min(value_cast(r.width()), value_cast(r.height()));
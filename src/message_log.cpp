@@ -47,6 +47,7 @@ public:
                && value_cast(r.height()) > 0);
 
         bounds_ = r;
+        ++generation_;
     }
 
     int visible_size() const noexcept final override {
@@ -61,6 +62,10 @@ public:
         return buffer_.data() + static_cast<ptrdiff_t>(buffer_.size());
     }
 
+    uint32_t generation() const noexcept final override {
+        return generation_;
+    }
+
 private:
     text_renderer& trender_;
     recti32        bounds_ {point2i32 {}, sizei32x {500}, sizei32y {200}};
@@ -69,6 +74,8 @@ private:
     std::vector<ref>                    buffer_;
     simple_circular_buffer<text_layout> visible_lines_ {10};
     simple_circular_buffer<std::string> messages_      {50};
+
+    uint32_t generation_ {0};
 };
 
 std::unique_ptr<message_log> make_message_log(text_renderer& trender) {
@@ -108,6 +115,7 @@ void message_log_impl::println(std::string msg) {
       , sizei32y {actual_h}};
 
     update_buffer_();
+    ++generation_;
 }
 
 } //namespace boken
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <memory>
+#include <cstdint>
 
 namespace boken { class text_renderer; }
 namespace boken { class text_layout; }
@@ -29,6 +30,9 @@ public:
 
     virtual ref const* visible_begin() const noexcept = 0;
     virtual ref const* visible_end() const noexcept = 0;
+
+    //! Changes whenever anything which affects how the log is drawn does.
+    virtual uint32_t generation() const noexcept = 0;
 };
 
 std::unique_ptr<message_log> make_message_log(text_renderer& trender);
@@ -2,6 +2,7 @@
 
 #include "item_pile.hpp"
 #include "object_fwd.hpp"
+#include "property_slots.hpp"
 
 #include <type_traits>
 #include <utility>
@@ -53,14 +54,26 @@ public:
     //                              Properties
     //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+    //! Slotted properties (see property_slot) are read directly from the slots
+    //! of this instance if it overrides them, else from those of the
+    //! definition; other properties are searched for in the instance and then
+    //! the definition.
     property_value_t property_value_or(
         definition_t     const& def
       , property_t       const  property
       , property_value_t const  fallback
     ) const noexcept {
         BK_ASSERT(def.id == definition());
-        return get_property_value_or(
-            property, fallback, properties_, def.properties);
+
+        auto const slot = property_slot_of(value_cast(property));
+        if (slot >= property_slot_count) {
+            return get_property_value_or(
+                property, fallback, properties_, def.properties);
+        }
+
+        return overrides_.has(slot)
+          ? overrides_.value_or(slot, fallback)
+          : def.slots.value_or(slot, fallback);
     }
 
     property_value_t property_value_or(
@@ -78,6 +91,11 @@ public:
         property_t       const property
       , property_value_t const value
     ) {
+        auto const slot = property_slot_of(value_cast(property));
+        if (slot < property_slot_count) {
+            overrides_.set(slot, value);
+        }
+
         return properties_.add_or_update_property(property, value);
     }
 
@@ -87,14 +105,23 @@ public:
 
     template <typename InputIt>
     int add_or_update_properties(InputIt first, InputIt last) {
-        return properties_.add_or_update_properties(first, last);
+        int result = 0;
+        for (; first != last; ++first) {
+            result += add_or_update_property(*first) ? 1 : 0;
+        }
+        return result;
     }
 
     int add_or_update_properties(std::initializer_list<property_pair_t> properties) {
-        return properties_.add_or_update_properties(properties);
+        return add_or_update_properties(std::begin(properties), std::end(properties));
     }
 
     bool remove_property(property_t const property) {
+        auto const slot = property_slot_of(value_cast(property));
+        if (slot < property_slot_count) {
+            overrides_.clear(slot);
+        }
+
         return properties_.remove_property(property);
     }
 private:
@@ -102,6 +129,9 @@ private:
     definition_id_t id_          {0};
     properties_t    properties_;
     item_pile       items_;
+
+    //! copies of the slotted values in properties_, read without a search
+    property_slot_values<property_value_t> overrides_;
 };
 
 } //namespace boken
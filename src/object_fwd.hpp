@@ -4,6 +4,7 @@
 #include "context_fwd.hpp"
 
 #include <functional>
+#include <vector>
 
 //=====--------------------------------------------------------------------=====
 //                            Forward Declarations
@@ -32,6 +33,10 @@ unique_entity create_object(world& w, std::function<entity (entity_instance_id)>
 unique_item create_object(game_database const& db, world& w, item_definition const& def, random_state& rng);
 unique_entity create_object(game_database const& db, world& w, entity_definition const& def, random_state& rng);
 
+// batch object creation; the new objects are appended to out
+void create_objects(game_database const& db, world& w, item_definition const& def, random_state& rng, size_t n, std::vector<unique_item>& out);
+void create_objects(game_database const& db, world& w, entity_definition const& def, random_state& rng, size_t n, std::vector<unique_entity>& out);
+
 // object -> instance
 entity_instance_id get_instance(entity const& e) noexcept;
 entity_instance_id get_instance(const_entity_descriptor e) noexcept;
@@ -0,0 +1,211 @@
+#include "path_service.hpp"
+#include "graph.hpp"
+#include "job_system.hpp"
+#include "level.hpp"
+#include "hash.hpp"
+#include "math.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+
+namespace boken {
+
+path_service::~path_service() = default;
+
+namespace {
+
+struct path_request {
+    path_service::request_id    id;
+    point2i32                   from;
+    point2i32                   to;
+    int32_t                     width;
+    int32_t                     height;
+    std::vector<uint8_t>        passable;
+    std::vector<point2i32>      path;
+    path_service::on_complete_f on_complete;
+    std::atomic<bool>           cancelled {false};
+};
+
+//! adapt a copy of the passability of a level to what the a_star_pather
+//! expects; the same graph as level_adapter, except that once the request is
+//! cancelled no node has any neighbors, so the search runs out of nodes and
+//! ends early.
+class passable_adapter {
+public:
+    using point = point2i32;
+
+    explicit passable_adapter(path_request const& r) noexcept : r_ {r} {}
+
+    bool is_passable(point const p) const noexcept {
+        return r_.passable[static_cast<size_t>(
+            value_cast(p.x) + value_cast(p.y) * r_.width)] != 0;
+    }
+
+    bool is_in_bounds(point const p) const noexcept {
+        return value_cast(p.x) >= 0 && value_cast(p.x) < r_.width
+            && value_cast(p.y) >= 0 && value_cast(p.y) < r_.height;
+    }
+
+    int32_t cost(point const, point const) const noexcept {
+        return 1;
+    }
+
+    template <typename Predicate, typename UnaryF>
+    void for_each_neighbor_if(point const p, Predicate pred, UnaryF f) const noexcept {
+        if (r_.cancelled.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        for_each_neighbor8_if(*this, p, pred, f);
+    }
+
+    int32_t width()  const noexcept { return r_.width; }
+    int32_t height() const noexcept { return r_.height; }
+    int32_t size()   const noexcept { return r_.width * r_.height; }
+private:
+    path_request const& r_;
+};
+
+} // namespace
+
+class path_service_impl final : public path_service {
+public:
+    explicit path_service_impl(job_system& jobs) noexcept
+      : jobs_ {jobs}
+    {
+    }
+
+    ~path_service_impl() {
+        cancel_all();
+        jobs_.wait(group_);
+    }
+
+    request_id request(
+        level const&  lvl
+      , point2i32     const from
+      , point2i32     const to
+      , on_complete_f on_complete
+    ) final override {
+        BK_ASSERT(intersects(lvl.bounds(), from)
+               && intersects(lvl.bounds(), to));
+
+        if (++next_id_ == 0) {
+            ++next_id_;
+        }
+
+        auto r = std::make_shared<path_request>();
+        r->id          = next_id_;
+        r->from        = from;
+        r->to          = to;
+        r->width       = value_cast(lvl.width());
+        r->height      = value_cast(lvl.height());
+        r->on_complete = std::move(on_complete);
+
+        lvl.copy_passable(r->passable);
+
+        pending_.push_back(r);
+
+        jobs_.run(group_, [this, r] {
+            if (!r->cancelled.load(std::memory_order_relaxed)) {
+                a_star_pather<passable_adapter> pather;
+
+                auto const p = pather.search(
+                    passable_adapter {*r}, r->from, r->to, diagonal_heuristic());
+
+                pather.reverse_copy_path(r->from, p, back_inserter(r->path));
+                std::reverse(begin(r->path), end(r->path));
+            }
+
+            std::lock_guard<std::mutex> lock {mutex_};
+            completed_.push_back(std::move(r));
+        }, djb2_hash_32c("path_service"));
+
+        return r->id;
+    }
+
+    bool cancel(request_id const id) noexcept final override {
+        auto const it = std::find_if(begin(pending_), end(pending_)
+          , [id](auto const& r) noexcept { return r->id == id; });
+
+        if (it == end(pending_)) {
+            return false;
+        }
+
+        (*it)->cancelled.store(true, std::memory_order_relaxed);
+        pending_.erase(it);
+
+        return true;
+    }
+
+    void cancel_all() noexcept final override {
+        for (auto const& r : pending_) {
+            r->cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        pending_.clear();
+    }
+
+    size_t poll() final override {
+        {
+            std::lock_guard<std::mutex> lock {mutex_};
+            if (completed_.empty()) {
+                return 0;
+            }
+
+            delivering_.swap(completed_);
+        }
+
+        size_t n = 0;
+
+        for (auto const& r : delivering_) {
+            if (r->cancelled.load(std::memory_order_relaxed)) {
+                continue;
+            }
+
+            auto const it = std::find(begin(pending_), end(pending_), r);
+            BK_ASSERT(it != end(pending_));
+            pending_.erase(it);
+
+            ++n;
+            if (r->on_complete) {
+                r->on_complete(r->id, r->path);
+            }
+        }
+
+        delivering_.clear();
+
+        return n;
+    }
+
+    void wait() final override {
+        jobs_.wait(group_);
+    }
+
+    size_t pending() const noexcept final override {
+        return pending_.size();
+    }
+private:
+    using request_ptr = std::shared_ptr<path_request>;
+
+    job_system& jobs_;
+    task_group  group_;
+
+    std::vector<request_ptr> pending_;    //!< made, but not yet delivered
+    std::vector<request_ptr> delivering_; //!< owned by poll()
+
+    std::mutex               mutex_;
+    std::vector<request_ptr> completed_;  //!< guarded by mutex_
+
+    request_id next_id_ {0};
+};
+
+std::unique_ptr<path_service> make_path_service(job_system& jobs) {
+    return std::make_unique<path_service_impl>(jobs);
+}
+
+} //namespace boken
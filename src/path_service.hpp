@@ -0,0 +1,67 @@
+#pragma once
+
+#include "math_types.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace boken { class job_system; }
+namespace boken { class level; }
+
+namespace boken {
+
+//! Finds paths on the worker threads of a job_system so that a long search
+//! doesn't stall the thread which asks for it.
+//!
+//! A request searches a copy of the passability of the level taken when it is
+//! made, so the level is free to change while the search runs; the result is
+//! delivered by poll(), which is to be called regularly from the thread which
+//! makes the requests (i.e. the main loop).
+class path_service {
+public:
+    using request_id = uint32_t;
+
+    //! Invoked from within poll() with the path from the start to the goal,
+    //! both included, or to the reachable point closest to the goal if there
+    //! is no path. A path of a single point means the start is as close as it
+    //! gets.
+    using on_complete_f = std::function<
+        void (request_id, std::vector<point2i32> const&)>;
+
+    virtual ~path_service();
+
+    //! Start a search for a path from @p from to @p to within @p lvl.
+    //! @returns An id for the request; never 0.
+    //! @pre @p from and @p to are within the bounds of @p lvl.
+    virtual request_id request(level const& lvl, point2i32 from, point2i32 to
+                             , on_complete_f on_complete) = 0;
+
+    //! Cancel a pending request; its callback won't be invoked, and the search
+    //! is abandoned as soon as possible if it has already started.
+    //! @returns true if the request was pending; otherwise false.
+    virtual bool cancel(request_id id) noexcept = 0;
+
+    //! Cancel every pending request.
+    virtual void cancel_all() noexcept = 0;
+
+    //! Invoke the callback of each request which has completed since the last
+    //! call, in the order they completed.
+    //! @returns The number of callbacks invoked.
+    virtual size_t poll() = 0;
+
+    //! Block until every search started so far has finished; the callbacks
+    //! are still only invoked by poll().
+    virtual void wait() = 0;
+
+    //! The number of requests made but not yet delivered or cancelled.
+    virtual size_t pending() const noexcept = 0;
+};
+
+//! @note @p jobs must outlive the service.
+std::unique_ptr<path_service> make_path_service(job_system& jobs);
+
+} //namespace boken
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "hash.hpp"
+#include "math_types.hpp"
+#include "property_set.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <array>
+#include <utility>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace boken {
+
+//! Properties which are read frequently enough to warrant a dense slot of their
+//! own. The slot assignment is shared by entities and items; a property which
+//! isn't meaningful for one type of object simply never has its slot filled.
+enum class property_slot : uint32_t {
+    tile_index
+  , can_equip
+  , ai_type
+  , is_player
+  , weight
+  , capacity
+  , stack_size
+  , current_stack_size
+  , identified
+
+  , count_ //!< the number of slots; not a valid slot
+};
+
+constexpr size_t property_slot_count = static_cast<size_t>(property_slot::count_);
+
+//! The property (string hash) associated with @p slot.
+constexpr uint32_t property_slot_id(property_slot const slot) noexcept {
+    return slot == property_slot::tile_index         ? djb2_hash_32c("tile_index")
+         : slot == property_slot::can_equip          ? djb2_hash_32c("can_equip")
+         : slot == property_slot::ai_type            ? djb2_hash_32c("ai_type")
+         : slot == property_slot::is_player          ? djb2_hash_32c("is_player")
+         : slot == property_slot::weight             ? djb2_hash_32c("weight")
+         : slot == property_slot::capacity           ? djb2_hash_32c("capacity")
+         : slot == property_slot::stack_size         ? djb2_hash_32c("stack_size")
+         : slot == property_slot::current_stack_size ? djb2_hash_32c("current_stack_size")
+         : slot == property_slot::identified         ? djb2_hash_32c("identified")
+         : 0u;
+}
+
+//! @returns The slot index for the property given by the string hash @p id,
+//!          or property_slot_count if the property doesn't have a slot.
+inline size_t property_slot_of(uint32_t const id) noexcept {
+    using ps = property_slot;
+    auto const to_index = [](ps const slot) noexcept {
+        return static_cast<size_t>(slot);
+    };
+
+    switch (id) {
+    case property_slot_id(ps::tile_index)         : return to_index(ps::tile_index);
+    case property_slot_id(ps::can_equip)          : return to_index(ps::can_equip);
+    case property_slot_id(ps::ai_type)            : return to_index(ps::ai_type);
+    case property_slot_id(ps::is_player)          : return to_index(ps::is_player);
+    case property_slot_id(ps::weight)             : return to_index(ps::weight);
+    case property_slot_id(ps::capacity)           : return to_index(ps::capacity);
+    case property_slot_id(ps::stack_size)         : return to_index(ps::stack_size);
+    case property_slot_id(ps::current_stack_size) : return to_index(ps::current_stack_size);
+    case property_slot_id(ps::identified)         : return to_index(ps::identified);
+    default                                       : break;
+    }
+
+    return property_slot_count;
+}
+
+//! A mask with the bit for @p slot set.
+constexpr uint32_t property_slot_bit(size_t const slot) noexcept {
+    return uint32_t {1} << slot;
+}
+
+static_assert(property_slot_count <= 32, "");
+
+//! The values of the slotted properties of a definition (or those overridden
+//! by an instance) along with a mask indicating which of the slots are
+//! present.
+template <typename Value>
+class property_slot_values {
+public:
+    using value_type = Value;
+
+    //! (Re)build the slots from the full set of properties.
+    template <typename Property>
+    void assign(property_set<Property, Value> const& properties) noexcept {
+        present_ = 0;
+        values_.fill(Value {});
+
+        for (auto const& p : properties) {
+            auto const slot = property_slot_of(value_cast(p.first));
+            if (slot < property_slot_count) {
+                values_[slot] = p.second;
+                present_ |= property_slot_bit(slot);
+            }
+        }
+    }
+
+    //! Set the value of @p slot and mark it as present.
+    void set(size_t const slot, value_type const value) noexcept {
+        BK_ASSERT(slot < property_slot_count);
+        values_[slot] = value;
+        present_ |= property_slot_bit(slot);
+    }
+
+    //! Mark @p slot as not present.
+    void clear(size_t const slot) noexcept {
+        BK_ASSERT(slot < property_slot_count);
+        values_[slot] = Value {};
+        present_ &= ~property_slot_bit(slot);
+    }
+
+    bool has(size_t const slot) const noexcept {
+        return !!(present_ & property_slot_bit(slot));
+    }
+
+    value_type value_or(size_t const slot, value_type const fallback) const noexcept {
+        return has(slot) ? values_[slot] : fallback;
+    }
+
+    value_type value_or(property_slot const slot, value_type const fallback) const noexcept {
+        return value_or(static_cast<size_t>(slot), fallback);
+    }
+private:
+    std::array<value_type, property_slot_count> values_ {};
+    uint32_t present_ = 0;
+};
+
+} //namespace boken
@@ -25,6 +25,11 @@ class random_state_impl final : public random_state {
 public:
     random_state_impl() = default;
 
+    explicit random_state_impl(uint64_t const seed)
+      : state {seed}
+    {
+    }
+
     result_type generate() noexcept final override;
 
     boost::random::uniform_smallint<int32_t>         dist_coin    {0, 1};
@@ -42,6 +47,10 @@ std::unique_ptr<random_state> make_random_state() {
     return std::make_unique<random_state_impl>();
 }
 
+std::unique_ptr<random_state> make_random_state(uint64_t const seed) {
+    return std::make_unique<random_state_impl>(seed);
+}
+
 bool random_coin_flip(random_state& rng) noexcept {
     auto& r = reinterpret_cast<random_state_impl&>(rng);
     return !!r.dist_coin(r.state);
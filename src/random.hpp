@@ -26,6 +26,9 @@ public:
 
 std::unique_ptr<random_state> make_random_state();
 
+//! A random state with a sequence determined entirely by @p seed.
+std::unique_ptr<random_state> make_random_state(uint64_t seed);
+
 //===------------------------------------------------------------------------===
 //                          Primitive algorithms
 //===------------------------------------------------------------------------===
@@ -1,4 +1,5 @@
 #include "render.hpp"
+#include "render_list.hpp"
 #include "level.hpp"
 #include "math.hpp"
 #include "rect.hpp"
@@ -12,6 +13,13 @@
 
 #include <bkassert/assert.hpp>
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <tuple>
 #include <vector>
 #include <cstdint>
 
@@ -51,8 +59,137 @@ void render_text(
     r.draw_tiles(params);
 }
 
+//! A coarse spatial index: at most one value per tile, binned by the square
+//! chunk of the map its tile falls within, so that finding the values within a
+//! region only looks at the chunks which intersect it. A dense table of the
+//! slot each tile's value occupies within its chunk makes finding, setting and
+//! erasing the value at a tile constant time.
+template <typename T>
+class chunked_vector {
+public:
+    static constexpr int32_t chunk_size = 16;
+
+    //! Discard all values and cover a map of @p width x @p height tiles.
+    void reset(sizei32x const width, sizei32y const height) {
+        width_    = value_cast(width);
+        height_   = value_cast(height);
+        chunks_x_ = (width_  + chunk_size - 1) / chunk_size;
+        chunks_y_ = (height_ + chunk_size - 1) / chunk_size;
+
+        chunks_.clear();
+        chunks_.resize(static_cast<size_t>(chunks_x_ * chunks_y_));
+
+        slots_.clear();
+        slots_.resize(static_cast<size_t>(width_ * height_), no_slot());
+    }
+
+    void clear() noexcept {
+        for (auto& c : chunks_) {
+            c.values.clear();
+            c.tiles.clear();
+        }
+
+        std::fill(begin(slots_), end(slots_), no_slot());
+    }
+
+    //! @returns The value at @p p if there is one; otherwise nullptr.
+    T* find(point2i32 const p) noexcept {
+        auto const slot = slots_[tile_index_(p)];
+        return (slot == no_slot())
+          ? nullptr
+          : &chunk_at_(p).values[slot];
+    }
+
+    //! Set the value at @p p to @p value; adding it if there isn't one.
+    void set(point2i32 const p, T const& value) {
+        auto const i    = tile_index_(p);
+        auto&      slot = slots_[i];
+
+        if (slot != no_slot()) {
+            chunk_at_(p).values[slot] = value;
+            return;
+        }
+
+        auto& c = chunk_at_(p);
+        slot = static_cast<uint32_t>(c.values.size());
+        c.values.push_back(value);
+        c.tiles.push_back(static_cast<uint32_t>(i));
+    }
+
+    //! Erase the value at @p p; the last value of the chunk takes its slot.
+    //! @returns false if there was no value at @p p; otherwise true.
+    bool erase(point2i32 const p) noexcept {
+        auto const i    = tile_index_(p);
+        auto const slot = slots_[i];
+
+        if (slot == no_slot()) {
+            return false;
+        }
+
+        auto& c = chunk_at_(p);
+
+        if (slot + 1u != c.values.size()) {
+            c.values[slot] = std::move(c.values.back());
+            c.tiles[slot]  = c.tiles.back();
+            slots_[c.tiles[slot]] = slot;
+        }
+
+        c.values.pop_back();
+        c.tiles.pop_back();
+
+        slots_[i] = no_slot();
+
+        return true;
+    }
+
+    //! Invoke f(values) for each chunk which intersects the region of tiles
+    //! @p r.
+    template <typename UnaryF>
+    void for_each_chunk_in(recti32 const r, UnaryF f) const {
+        auto const x0 = std::max(0, value_cast(r.x0) / chunk_size);
+        auto const y0 = std::max(0, value_cast(r.y0) / chunk_size);
+        auto const x1 = std::min(chunks_x_, (value_cast(r.x1) + chunk_size - 1) / chunk_size);
+        auto const y1 = std::min(chunks_y_, (value_cast(r.y1) + chunk_size - 1) / chunk_size);
+
+        for (auto y = y0; y < y1; ++y) {
+            for (auto x = x0; x < x1; ++x) {
+                f(chunks_[static_cast<size_t>(x + y * chunks_x_)].values);
+            }
+        }
+    }
+private:
+    static constexpr uint32_t no_slot() noexcept { return 0xFFFFFFFFu; }
+
+    struct chunk {
+        std::vector<T>        values;
+        std::vector<uint32_t> tiles; //!< the index of the tile of each value
+    };
+
+    size_t tile_index_(point2i32 const p) const noexcept {
+        BK_ASSERT(value_cast(p.x) >= 0 && value_cast(p.x) < width_
+               && value_cast(p.y) >= 0 && value_cast(p.y) < height_);
+
+        return static_cast<size_t>(value_cast(p.x) + value_cast(p.y) * width_);
+    }
+
+    chunk& chunk_at_(point2i32 const p) noexcept {
+        auto const cx = value_cast(p.x) / chunk_size;
+        auto const cy = value_cast(p.y) / chunk_size;
+        return chunks_[static_cast<size_t>(cx + cy * chunks_x_)];
+    }
+
+    std::vector<chunk>    chunks_;
+    std::vector<uint32_t> slots_; //!< per tile, row by row; or no_slot()
+    int32_t width_    {0};
+    int32_t height_   {0};
+    int32_t chunks_x_ {0};
+    int32_t chunks_y_ {0};
+};
+
 } //namespace
 
+renderer2d::~renderer2d() = default;
+
 render_task::~render_task() = default;
 
 //=====--------------------------------------------------------------------=====
@@ -69,25 +206,33 @@ public:
     //---render_task interface
     void render(duration_t delta, renderer2d& r, view const& v) final override;
 
+    uint32_t generation() const noexcept final override {
+        return generation_;
+    }
+
     //---tool_tip_renderer interface
     bool is_visible() const noexcept final override {
         return text_.is_visible();
     }
 
     bool visible(bool const state) noexcept final override {
+        ++generation_;
         return text_.visible(state);
     }
 
     void set_text(std::string text) final override {
+        ++generation_;
         text_.layout(trender_, std::move(text));
     }
 
     void set_position(point2i32 const p) noexcept final override {
+        ++generation_;
         text_.move_to(value_cast(p.x), value_cast(p.y));
     }
 private:
     text_renderer& trender_;
     text_layout    text_;
+    uint32_t       generation_ {0};
 };
 
 std::unique_ptr<tool_tip_renderer> make_tool_tip_renderer(text_renderer& tr) {
@@ -155,6 +300,15 @@ void tool_tip_renderer_impl::render(duration_t, renderer2d& r, view const&) {
 //=====--------------------------------------------------------------------=====
 message_log_renderer::~message_log_renderer() = default;
 
+namespace {
+
+// how long the message log waits, then takes, to fade out
+constexpr std::chrono::milliseconds fade_time      {3000};
+constexpr std::chrono::milliseconds fade_lead_time {1000};
+constexpr auto fade_total_time = fade_time + fade_lead_time;
+
+} // namespace
+
 class message_log_renderer_impl final : public message_log_renderer {
 public:
     message_log_renderer_impl(text_renderer& tr, message_log const& log) noexcept
@@ -166,11 +320,20 @@ public:
     //---render_task interface
     void render(duration_t delta, renderer2d& r, view const& v) final override;
 
+    uint32_t generation() const noexcept final override {
+        return generation_ + (log_ ? log_->generation() : 0u);
+    }
+
+    bool is_animating() const noexcept final override {
+        return !fading_ || fade_time_ < fade_total_time;
+    }
+
     //---message_log_renderer interface
     void resize(vec2i32 const delta) final override {
     }
 
     void show() final override {
+        ++generation_;
         fading_ = false;
         fade_time_ = duration_t {};
     }
@@ -194,6 +357,7 @@ private:
     text_renderer& trender_;
     bool fading_ = false;
     duration_t fade_time_ {};
+    uint32_t generation_ {0};
 };
 
 std::unique_ptr<message_log_renderer> make_message_log_renderer(
@@ -208,10 +372,6 @@ void message_log_renderer_impl::render(duration_t const delta, renderer2d& r, vi
         return;
     }
 
-    constexpr std::chrono::milliseconds fade_time      {3000};
-    constexpr std::chrono::milliseconds fade_lead_time {1000};
-    constexpr auto fade_total_time = fade_time + fade_lead_time;
-
     if (fading_ == false) {
         fading_ = true;
         fade_time_ = duration_t {};
@@ -269,8 +429,13 @@ public:
     //---render_task interface
     void render(duration_t delta, renderer2d& r, view const& v) final override;
 
+    uint32_t generation() const noexcept final override {
+        return generation_ + (list_ ? list_->generation() : 0u);
+    }
+
     //---tool_tip_renderer interface
     bool set_focus(bool const state) noexcept final override {
+        ++generation_;
         auto const result = has_focus_;
         has_focus_ = state;
         return result;
@@ -279,6 +444,7 @@ private:
     text_renderer& trender_;
     inventory_list const* list_;
     bool has_focus_ = false;
+    uint32_t generation_ {0};
 };
 
 std::unique_ptr<item_list_renderer>
@@ -422,8 +588,13 @@ public:
     //---render_task interface
     void render(duration_t delta, renderer2d& r, view const& v) final override;
 
+    uint32_t generation() const noexcept final override {
+        return generation_;
+    }
+
     //---map_renderer interface
     bool debug_toggle_show_regions() noexcept final override {
+        ++generation_;
         bool const result = debug_show_regions_;
         debug_show_regions_ = !debug_show_regions_;
         return result;
@@ -445,6 +616,7 @@ public:
     }
 
     void highlight_clear() final override {
+        ++generation_;
         highlighted_tiles_.clear();
     }
 
@@ -453,17 +625,21 @@ public:
             return;
         }
 
-        entity_data.clear();
-        item_data.clear();
+        entity_data.reset(lvl.width(), lvl.height());
+        item_data.reset(lvl.width(), lvl.height());
         tile_data.clear();
         highlight_clear();
+        reset_terrain_chunks_(lvl.width(), lvl.height());
 
         level_ = &lvl;
+        ++generation_;
     }
 
     void set_tile_maps(
         std::initializer_list<std::pair<tile_map_type, tile_map const&>> tmaps
     ) noexcept final override {
+        ++generation_;
+
         for (auto const& p : tmaps) {
             switch (p.first) {
             case tile_map_type::base   : tile_map_base_     = &p.second; break;
@@ -476,6 +652,7 @@ public:
     }
 
     void set_pile_id(item_id const id) noexcept final override {
+        ++generation_;
         pile_id_ = id;
     }
 
@@ -526,6 +703,7 @@ public:
         update_t<entity_id> const* first
       , update_t<entity_id> const* last
     ) final override {
+        ++generation_;
         update_data_(entity_data, first, last, *tile_map_entities_);
     }
 
@@ -533,6 +711,7 @@ public:
         update_t<item_id> const* first
       , update_t<item_id> const* last
     ) final override {
+        ++generation_;
         update_data_(item_data, first, last, *tile_map_items_);
     }
 private:
@@ -548,6 +727,41 @@ private:
         uint32_t  color;
     };
 
+    //! The region of tiles of the level within the window; i.e. the only tiles
+    //! worth drawing.
+    recti32 visible_tiles_(renderer2d const& r, view const& v) const noexcept;
+
+    //! Draw the terrain within @p visible by copying the cached chunks which
+    //! cover it; (re)drawing into the cache first any which are dirty.
+    //! @returns false if the cache can't be used; nothing is drawn.
+    bool render_terrain_cached_(renderer2d& r, recti32 visible);
+
+    //! Draw the terrain of the chunk at (@p cx, @p cy) into @p texture.
+    void draw_terrain_chunk_(renderer2d& r, int32_t cx, int32_t cy, uint32_t texture);
+
+    //! A texture for a chunk of terrain; one no longer used, a new one, or
+    //! failing that, the one of the chunk least recently in view.
+    uint32_t acquire_target_(renderer2d& r);
+
+    void reset_terrain_chunks_(sizei32x width, sizei32y height);
+
+    //! Mark the chunks which intersect the region of tiles @p r as needing to
+    //! be drawn again.
+    void invalidate_terrain_(recti32 r) noexcept;
+
+    //! Order visible_data_ by color so that each color is drawn as a run; a
+    //! renderer which has to change its color mod to change colors then does
+    //! so once per color rather than per tile. The tiles of a layer don't
+    //! overlap, so this doesn't change what is drawn; tiles of the same color
+    //! keep their order.
+    void sort_visible_by_color_();
+
+    //! Fill visible_data_ with the data within @p visible from @p data.
+    void gather_visible_(
+        chunked_vector<data_t> const& data
+      , tile_map const&               tmap
+      , recti32                       visible);
+
     static auto tile_pos_to_rect_(tile_map const& tmap) noexcept {
         auto const w  = tmap.tile_width();
         auto const h  = tmap.tile_height();
@@ -584,8 +798,7 @@ private:
 
     static auto get_tex_coord(tile_map const& tmap) noexcept {
         return [&](auto const id) {
-            return underlying_cast_unsafe<int16_t>(
-                tmap.index_to_rect(id_to_index(tmap, id)).top_left());
+            return tmap.tex_coord(id);
         };
     }
 
@@ -625,9 +838,9 @@ private:
         }
     }
 
-    template <typename Data, typename Type>
+    template <typename Type>
     void update_data_(
-        Data&                       data
+        chunked_vector<data_t>&     data
       , update_t<Type> const* const first
       , update_t<Type> const* const last
       , tile_map const&             tmap
@@ -639,43 +852,60 @@ private:
         };
 
         std::for_each(first, last, [&](update_t<Type> const& update) {
-            auto const p = tranform(update.prev_pos);
-
-            auto const first_d = begin(data);
-            auto const last_d  = end(data);
-
-            auto const it = std::find_if(first_d, last_d
-              , [&](data_t const& d) noexcept { return d.position == p; });
-
             // data to remove
             if (update.id == nullptr) {
-                BK_ASSERT(it != last_d);
-
-                // equivalent to  data.erase(it)
-                std::swap(*it, data.back());
-                data.pop_back();
-
+                if (!data.erase(update.prev_pos)) {
+                    BK_ASSERT(false);
+                }
                 return;
             }
 
             // new data
-            if (it == last_d) {
-                data.push_back({p, tex_coord(update.id), get_color(update)});
+            if (!data.find(update.prev_pos)) {
+                data.set(update.prev_pos, {tranform(update.prev_pos)
+                  , tex_coord(update.id), get_color(update)});
                 return;
             }
 
             // data to update
-            it->position  = tranform(update.next_pos);
-            it->tex_coord = tex_coord(update.id);
-            it->color     = get_color(update);
+            if (update.next_pos != update.prev_pos) {
+                data.erase(update.prev_pos);
+            }
+
+            data.set(update.next_pos, {tranform(update.next_pos)
+              , tex_coord(update.id), get_color(update)});
         });
     }
 private:
     level const* level_ {};
 
-    std::vector<data_t> tile_data;
-    std::vector<data_t> entity_data;
-    std::vector<data_t> item_data;
+    std::vector<data_t>    tile_data;   //!< row by row for the whole level
+    chunked_vector<data_t> entity_data;
+    chunked_vector<data_t> item_data;
+
+    std::vector<data_t>    visible_data_; //!< the data submitted by render
+
+    static constexpr uint32_t no_texture = 0xFFFFFFFFu;
+
+    //! A chunk of the terrain (the same chunks as chunked_vector) drawn into a
+    //! texture of its own, which is only drawn into again after a change.
+    struct terrain_chunk {
+        uint32_t texture    {no_texture};
+        uint32_t last_frame {0};    //!< the frame it was last in view
+        bool     dirty      {true}; //!< the texture is out of date
+    };
+
+    //! A soft limit; if more chunks than this are in view at once, more
+    //! textures are made regardless.
+    static constexpr uint32_t max_terrain_targets = 64;
+
+    std::vector<terrain_chunk> terrain_chunks_;
+    std::vector<uint32_t>      free_targets_;   //!< made, but used by no chunk
+    int32_t                    terrain_chunks_x_  {0};
+    int32_t                    terrain_chunks_y_  {0};
+    uint32_t                   terrain_targets_   {0}; //!< made so far
+    uint32_t                   terrain_frame_     {0};
+    uint32_t                   target_generation_ {0};
 
     tile_map const* tile_map_base_     {};
     tile_map const* tile_map_entities_ {};
@@ -686,23 +916,313 @@ private:
     std::vector<point2i32> highlighted_tiles_;
 
     bool debug_show_regions_ = false;
+
+    uint32_t generation_ {0};
 };
 
 std::unique_ptr<map_renderer> make_map_renderer() {
     return std::make_unique<map_renderer_impl>();
 }
 
+recti32 map_renderer_impl::visible_tiles_(
+    renderer2d const& r
+  , view       const& v
+) const noexcept {
+    auto const& tmap   = *tile_map_base_;
+    auto const  client = r.get_client_rect();
+    auto const  tw     = tmap.tile_width();
+    auto const  th     = tmap.tile_height();
+
+    auto const p0 = v.window_to_world(client.top_left(),     tw, th);
+    auto const p1 = v.window_to_world(client.bottom_right(), tw, th);
+
+    // one extra tile on each side covers the rounding of the translation
+    auto const r0 = recti32 {
+        point2i32 {floor_as<int32_t>(value_cast(p0.x)) - 1
+                 , floor_as<int32_t>(value_cast(p0.y)) - 1}
+      , point2i32 {ceil_as<int32_t>(value_cast(p1.x)) + 1
+                 , ceil_as<int32_t>(value_cast(p1.y)) + 1}};
+
+    auto const bounds = level_->bounds();
+    if (!intersects(r0, bounds)) {
+        return recti32 {};
+    }
+
+    return clamp(r0, bounds);
+}
+
+void map_renderer_impl::reset_terrain_chunks_(
+    sizei32x const width
+  , sizei32y const height
+) {
+    constexpr auto n = chunked_vector<data_t>::chunk_size;
+
+    for (auto const& c : terrain_chunks_) {
+        if (c.texture != no_texture) {
+            free_targets_.push_back(c.texture);
+        }
+    }
+
+    terrain_chunks_x_ = (value_cast(width)  + n - 1) / n;
+    terrain_chunks_y_ = (value_cast(height) + n - 1) / n;
+
+    terrain_chunks_.clear();
+    terrain_chunks_.resize(
+        static_cast<size_t>(terrain_chunks_x_ * terrain_chunks_y_));
+}
+
+void map_renderer_impl::invalidate_terrain_(recti32 const r) noexcept {
+    constexpr auto n = chunked_vector<data_t>::chunk_size;
+
+    auto const x0 = std::max(0, value_cast(r.x0) / n);
+    auto const y0 = std::max(0, value_cast(r.y0) / n);
+    auto const x1 = std::min(terrain_chunks_x_, (value_cast(r.x1) + n - 1) / n);
+    auto const y1 = std::min(terrain_chunks_y_, (value_cast(r.y1) + n - 1) / n);
+
+    for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; ++x) {
+            terrain_chunks_[static_cast<size_t>(x + y * terrain_chunks_x_)].dirty = true;
+        }
+    }
+}
+
+uint32_t map_renderer_impl::acquire_target_(renderer2d& r) {
+    constexpr auto n = chunked_vector<data_t>::chunk_size;
+
+    if (!free_targets_.empty()) {
+        auto const result = free_targets_.back();
+        free_targets_.pop_back();
+        return result;
+    }
+
+    auto const make_target = [&] {
+        // every chunk is the same size; the chunks at the right and bottom
+        // edges of the level are only partly used
+        ++terrain_targets_;
+        return r.create_target(n * tile_map_base_->tile_width()
+                             , n * tile_map_base_->tile_height());
+    };
+
+    if (terrain_targets_ < max_terrain_targets) {
+        return make_target();
+    }
+
+    terrain_chunk* lru = nullptr;
+    for (auto& c : terrain_chunks_) {
+        if (c.texture == no_texture || c.last_frame == terrain_frame_) {
+            continue;
+        }
+
+        if (!lru || c.last_frame < lru->last_frame) {
+            lru = &c;
+        }
+    }
+
+    if (!lru) {
+        return make_target();
+    }
+
+    auto const result = lru->texture;
+    lru->texture = no_texture;
+    return result;
+}
+
+void map_renderer_impl::draw_terrain_chunk_(
+    renderer2d&    r
+  , int32_t  const cx
+  , int32_t  const cy
+  , uint32_t const texture
+) {
+    constexpr auto n = chunked_vector<data_t>::chunk_size;
+
+    auto const& tmap = *tile_map_base_;
+
+    auto const w  = value_cast(level_->width());
+    auto const x0 = cx * n;
+    auto const y0 = cy * n;
+    auto const x1 = std::min(w, x0 + n);
+    auto const y1 = std::min(value_cast(level_->height()), y0 + n);
+
+    visible_data_.clear();
+    for (auto y = y0; y < y1; ++y) {
+        auto const row = tile_data.data() + y * w;
+        visible_data_.insert(end(visible_data_), row + x0, row + x1);
+    }
+
+    sort_visible_by_color_();
+
+    r.set_target(texture);
+    r.set_transform({1.0f, 1.0f
+                   , static_cast<float>(-x0 * value_cast(tmap.tile_width()))
+                   , static_cast<float>(-y0 * value_cast(tmap.tile_height()))});
+    r.draw_tiles(make_uniform<data_t>(tmap, visible_data_));
+    r.set_target(renderer2d::screen_target);
+}
+
+bool map_renderer_impl::render_terrain_cached_(
+    renderer2d&   r
+  , recti32 const visible
+) {
+    constexpr auto n = chunked_vector<data_t>::chunk_size;
+
+    auto const w = value_cast(level_->width());
+    auto const h = value_cast(level_->height());
+
+    if (!r.has_targets()
+     || terrain_chunks_.empty()
+     || tile_data.size() < static_cast<size_t>(w * h)
+    ) {
+        return false;
+    }
+
+    // the contents of every texture have been lost
+    if (r.target_generation() != target_generation_) {
+        target_generation_ = r.target_generation();
+        for (auto& c : terrain_chunks_) {
+            c.dirty = true;
+        }
+    }
+
+    auto const x0 = value_cast(visible.x0) / n;
+    auto const y0 = value_cast(visible.y0) / n;
+    auto const x1 = std::min(terrain_chunks_x_, (value_cast(visible.x1) + n - 1) / n);
+    auto const y1 = std::min(terrain_chunks_y_, (value_cast(visible.y1) + n - 1) / n);
+
+    auto const chunk_at = [&](int32_t const x, int32_t const y) noexcept -> terrain_chunk& {
+        return terrain_chunks_[static_cast<size_t>(x + y * terrain_chunks_x_)];
+    };
+
+    // mark every chunk in view first so that none of them is chosen to give
+    // up its texture below
+    ++terrain_frame_;
+    for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; ++x) {
+            chunk_at(x, y).last_frame = terrain_frame_;
+        }
+    }
+
+    for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; ++x) {
+            auto& c = chunk_at(x, y);
+
+            if (c.texture == no_texture) {
+                c.texture = acquire_target_(r);
+                c.dirty   = true;
+            }
+
+            if (c.dirty) {
+                draw_terrain_chunk_(r, x, y, c.texture);
+                c.dirty = false;
+            }
+        }
+    }
+
+    auto const tw = value_cast(tile_map_base_->tile_width());
+    auto const th = value_cast(tile_map_base_->tile_height());
+
+    auto const size = point2i16 {static_cast<int16_t>(n * tw)
+                               , static_cast<int16_t>(n * th)};
+    auto const tex_coord = point2i16 {};
+    auto const color     = 0xFFFFFFFFu;
+
+    using ptr_t = read_only_pointer_t;
+
+    for (auto y = y0; y < y1; ++y) {
+        for (auto x = x0; x < x1; ++x) {
+            auto const p = point2i16 {static_cast<int16_t>(x * n * tw)
+                                    , static_cast<int16_t>(y * n * th)};
+
+            r.draw_tiles(renderer2d::tile_params_variable {
+                chunk_at(x, y).texture, 1
+              , ptr_t {&p,         &p + 1}
+              , ptr_t {&tex_coord, &tex_coord + 1}
+              , ptr_t {&size,      &size + 1}
+              , ptr_t {&color,     &color + 1}});
+        }
+    }
+
+    return true;
+}
+
+void map_renderer_impl::sort_visible_by_color_() {
+    auto const by_color = [](data_t const& a, data_t const& b) noexcept {
+        return a.color < b.color;
+    };
+
+    // often the case for items and entities, which are all the same color
+    if (std::is_sorted(begin(visible_data_), end(visible_data_), by_color)) {
+        return;
+    }
+
+    std::stable_sort(begin(visible_data_), end(visible_data_), by_color);
+}
+
+void map_renderer_impl::gather_visible_(
+    chunked_vector<data_t> const& data
+  , tile_map               const& tmap
+  , recti32                const  visible
+) {
+    auto const tw = value_cast(tmap.tile_width());
+    auto const th = value_cast(tmap.tile_height());
+
+    // the bounds in pixels
+    auto const x0 = value_cast(visible.x0) * tw;
+    auto const y0 = value_cast(visible.y0) * th;
+    auto const x1 = value_cast(visible.x1) * tw;
+    auto const y1 = value_cast(visible.y1) * th;
+
+    visible_data_.clear();
+
+    data.for_each_chunk_in(visible, [&](std::vector<data_t> const& chunk) {
+        for (auto const& d : chunk) {
+            auto const x = value_cast(d.position.x);
+            auto const y = value_cast(d.position.y);
+            if (x >= x0 && x < x1 && y >= y0 && y < y1) {
+                visible_data_.push_back(d);
+            }
+        }
+    });
+}
+
 void map_renderer_impl::render(duration_t, renderer2d& r, view const& v) {
      auto const trans = r.transform({v.scale_x, v.scale_y, v.x_off, v.y_off});
 
-    // Map tiles
-    r.draw_tiles(make_uniform<data_t>(*tile_map_base_, tile_data));
+    auto const visible = visible_tiles_(r, v);
+    if (value_cast(visible.area()) <= 0) {
+        return;
+    }
+
+    // Map tiles; only the part of each visible row within view, unless the
+    // cached chunks can be used instead
+    if (!render_terrain_cached_(r, visible)) {
+        auto const w  = static_cast<size_t>(value_cast(level_->width()));
+        auto const x0 = static_cast<size_t>(value_cast(visible.x0));
+        auto const x1 = static_cast<size_t>(value_cast(visible.x1));
+        auto const y0 = static_cast<size_t>(value_cast(visible.y0));
+        auto const y1 = static_cast<size_t>(value_cast(visible.y1));
+
+        visible_data_.clear();
+
+        if (tile_data.size() >= w * y1) {
+            for (auto y = y0; y < y1; ++y) {
+                auto const row = tile_data.data() + y * w;
+                visible_data_.insert(end(visible_data_), row + x0, row + x1);
+            }
+        }
+
+        sort_visible_by_color_();
+        r.draw_tiles(make_uniform<data_t>(*tile_map_base_, visible_data_));
+    }
 
     // Items
-    r.draw_tiles(make_uniform<data_t>(*tile_map_items_, item_data));
+    gather_visible_(item_data, *tile_map_items_, visible);
+    sort_visible_by_color_();
+    r.draw_tiles(make_uniform<data_t>(*tile_map_items_, visible_data_));
 
     // Entities
-    r.draw_tiles(make_uniform<data_t>(*tile_map_entities_, entity_data));
+    gather_visible_(entity_data, *tile_map_entities_, visible);
+    sort_visible_by_color_();
+    r.draw_tiles(make_uniform<data_t>(*tile_map_entities_, visible_data_));
 
     // tile highlight
     auto const border_size = 2;
@@ -740,6 +1260,9 @@ void map_renderer_impl::update_map_data() {
             out.tex_coord = tex_coord(tid);
             out.color     = choose_color(tid, rid);
         });
+
+    invalidate_terrain_(bounds);
+    ++generation_;
 }
 
 void map_renderer_impl::update_map_data(
@@ -763,6 +1286,9 @@ void map_renderer_impl::update_map_data(
             out.tex_coord = tex_coord(tid);
             out.color     = choose_color(tid, rid);
         });
+
+    invalidate_terrain_({point2i32 {x, y}, sizei32x {w}, sizei32y {h}});
+    ++generation_;
 }
 
 //=====--------------------------------------------------------------------=====
@@ -771,13 +1297,54 @@ game_renderer::~game_renderer() = default;
 
 class game_renderer_impl final : public game_renderer {
 public:
-    game_renderer_impl(system& os, text_renderer& trender)
-      : os_      {os}
-      , trender_ {trender}
+    game_renderer_impl(std::unique_ptr<renderer2d> r, text_renderer& trender)
+      : trender_  {trender}
+      , renderer_ {std::move(r)}
     {
+        if (renderer_->allows_any_thread()) {
+            thread_ = std::thread {[this] { run_(); }};
+        }
+    }
+
+    ~game_renderer_impl() {
+        wait();
+
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock {mutex_};
+                stop_ = true;
+            }
+
+            cv_.notify_all();
+            thread_.join();
+        }
+    }
+
+    bool render(duration_t delta, view const& v) const noexcept final override;
+
+    void wait() const noexcept final override {
+        std::unique_lock<std::mutex> lock {mutex_};
+        cv_.wait(lock, [&] { return !submitted_; });
+    }
+
+    frame_stats_t frame_stats() const noexcept final override {
+        std::lock_guard<std::mutex> lock {mutex_};
+        return frame_stats_;
     }
 
-    void render(duration_t delta, view const& v) const noexcept final override;
+    frame_counts_t frame_counts() const noexcept final override {
+        return frame_counts_;
+    }
+
+    bool is_animating() const noexcept final override {
+        return std::any_of(begin(tasks_), end(tasks_)
+          , [](task_info const& t) noexcept { return t.task->is_animating(); });
+    }
+
+    bool set_batching(bool const enabled) noexcept final override {
+        wait();
+        return renderer_->set_batching(enabled);
+    }
 
     void add_task_generic(
         string_view const id
@@ -786,6 +1353,7 @@ public:
     ) final override {
         BK_ASSERT(!!task && !id.empty());
         tasks_.push_back({std::move(task), id, zorder});
+        last_frame_.valid = false;
     }
 private:
     struct task_info {
@@ -794,19 +1362,138 @@ private:
         int zorder;
     };
 
-    system&        os_;
+    //! What the last frame drawn was drawn from; if none of it has changed,
+    //! and no task is animating, the next frame would be the same.
+    struct frame_key_t {
+        uint64_t generations; //!< the sum of those of the tasks
+        view     v;
+        recti32  client_rect;
+        uint32_t target_generation;
+        bool     valid;
+    };
+
+    frame_key_t make_frame_key_(view const& v) const noexcept;
+
+    //! Draw and present the tasks straight to renderer_; without a render
+    //! thread there is nothing to gain by recording them first.
+    void render_direct_(duration_t delta, view const& v) const noexcept;
+
+    //! Draw and present @p list, recorded in @p record_time.
+    void draw_(render_list const& list, duration_t record_time) const noexcept;
+
+    //! The body of the render thread.
+    void run_() const noexcept;
+
     text_renderer& trender_;
 
-    std::unique_ptr<renderer2d> renderer_ = make_renderer(os_);
+    std::unique_ptr<renderer2d> renderer_;
     std::vector<task_info> tasks_;
+
+    frame_key_t    mutable last_frame_   {};
+    frame_counts_t mutable frame_counts_ {};
+
+    // with a render thread, frames are recorded into one list while the other
+    // is drawn
+    std::array<render_list, 2> mutable lists_ {{
+        render_list {*renderer_, [this] { wait(); }}
+      , render_list {*renderer_, [this] { wait(); }}}};
+    size_t mutable back_ {0}; //!< the list to record into next
+
+    std::thread                     thread_;
+    std::mutex              mutable mutex_;
+    std::condition_variable mutable cv_;
+
+    // guarded by mutex_
+    bool          mutable submitted_   {false}; //!< a list is yet to be drawn
+    duration_t    mutable record_time_ {};      //!< of the submitted list
+    bool          mutable stop_        {false};
+    frame_stats_t mutable frame_stats_ {};
 };
 
 std::unique_ptr<game_renderer> make_game_renderer(system& os, text_renderer& trender) {
-    return std::make_unique<game_renderer_impl>(os, trender);
+    return make_game_renderer(make_renderer(os), trender);
+}
+
+std::unique_ptr<game_renderer>
+make_game_renderer(std::unique_ptr<renderer2d> r, text_renderer& trender) {
+    BK_ASSERT(!!r);
+    return std::make_unique<game_renderer_impl>(std::move(r), trender);
+}
+
+game_renderer_impl::frame_key_t
+game_renderer_impl::make_frame_key_(view const& v) const noexcept {
+    auto const generations = std::accumulate(begin(tasks_), end(tasks_), uint64_t {0}
+      , [](uint64_t const sum, task_info const& t) noexcept {
+            return sum + t.task->generation();
+        });
+
+    return {generations, v, renderer_->get_client_rect()
+          , renderer_->target_generation(), true};
 }
 
-void game_renderer_impl::render(duration_t const delta, view const& v) const noexcept {
+bool game_renderer_impl::render(duration_t const delta, view const& v) const noexcept {
+    using clock_t = render_task::clock_t;
+
+    // generations only ever increase, so neither does their sum unless one of
+    // them changed
+    auto const key = make_frame_key_(v);
+    auto const& k0 = last_frame_;
+
+    auto const unchanged = k0.valid
+        && key.generations       == k0.generations
+        && key.client_rect       == k0.client_rect
+        && key.target_generation == k0.target_generation
+        && std::tie(key.v.x_off, key.v.y_off, key.v.scale_x, key.v.scale_y)
+        == std::tie(k0.v.x_off,  k0.v.y_off,  k0.v.scale_x,  k0.v.scale_y);
+
+    if (unchanged && !is_animating()) {
+        ++frame_counts_.skipped;
+        return false;
+    }
+
+    last_frame_ = key;
+    ++frame_counts_.drawn;
+
+    if (!thread_.joinable()) {
+        render_direct_(delta, v);
+        return true;
+    }
+
+    auto& list = lists_[back_];
+    auto const t0 = clock_t::now();
+
+    // the list was drawn no later than when the previous list was submitted
+    list.reset(renderer_->get_client_rect());
+    list.transform();
+    list.draw_background();
+
+    for (auto const& t : tasks_) {
+        t.task->render(delta, list, v);
+    }
+
+    auto const record_time = clock_t::now() - t0;
+
+    {
+        std::unique_lock<std::mutex> lock {mutex_};
+        cv_.wait(lock, [&] { return !submitted_; });
+
+        submitted_   = true;
+        record_time_ = record_time;
+        back_        = (back_ + 1u) % lists_.size();
+    }
+
+    cv_.notify_all();
+    return true;
+}
+
+void game_renderer_impl::render_direct_(
+    duration_t const  delta
+  , view       const& v
+) const noexcept {
+    using clock_t = render_task::clock_t;
+
     auto& r = *renderer_;
+    auto const t0 = clock_t::now();
 
     r.render_clear();
     r.transform();
@@ -816,7 +1503,62 @@ void game_renderer_impl::render(duration_t const delta, view const& v) const noe
         t.task->render(delta, r, v);
     }
 
+    // the stats are read before presenting so that they don't include
+    // waiting for vsync
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        frame_stats_.counts = r.stats();
+        frame_stats_.time   = clock_t::now() - t0;
+    }
+
     r.render_present();
 }
 
+void game_renderer_impl::draw_(
+    render_list const& list
+  , duration_t  const  record_time
+) const noexcept {
+    using clock_t = render_task::clock_t;
+
+    auto& r = *renderer_;
+    auto const t0 = clock_t::now();
+
+    r.render_clear();
+    list.replay();
+
+    // the stats are read before presenting so that they don't include
+    // waiting for vsync
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        frame_stats_.counts = r.stats();
+        frame_stats_.time   = record_time + (clock_t::now() - t0);
+    }
+
+    r.render_present();
+}
+
+void game_renderer_impl::run_() const noexcept {
+    for (;;) {
+        std::unique_lock<std::mutex> lock {mutex_};
+        cv_.wait(lock, [&] { return submitted_ || stop_; });
+
+        if (!submitted_) {
+            return;
+        }
+
+        // the list submitted is the one before the next to be recorded
+        auto const& list = lists_[(back_ + 1u) % lists_.size()];
+        auto const  time = record_time_;
+
+        lock.unlock();
+        draw_(list, time);
+        lock.lock();
+
+        submitted_ = false;
+        lock.unlock();
+
+        cv_.notify_all();
+    }
+}
+
 } //namespace boken
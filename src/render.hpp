@@ -172,6 +172,14 @@ public:
         read_only_pointer_t colors;
     };
 
+    //! Counts since the last call to render_clear(); i.e. for the current (or,
+    //! after render_present(), last) frame.
+    struct stats_t {
+        uint32_t draw_calls;    //!< calls made to the underlying API to draw
+        uint32_t tiles;         //!< tiles drawn by draw_tiles
+        uint32_t state_changes; //!< of the texture, or its color mod, between tiles
+    };
+
     struct transform_t {
         float scale_x;
         float scale_y;
@@ -281,6 +289,40 @@ public:
 
     virtual void draw_tiles(tile_params_uniform  const& params) = 0;
     virtual void draw_tiles(tile_params_variable const& params) = 0;
+
+    //! The id of the window for set_target.
+    static constexpr uint32_t screen_target = 0xFFFFFFFFu;
+
+    //! Whether textures can be drawn to; if not, create_target and set_target
+    //! must not be used.
+    virtual bool has_targets() const noexcept = 0;
+
+    //! Create a texture of @p w x @p h pixels which can be drawn to with
+    //! set_target, and drawn from like any other texture with draw_tiles.
+    //! @returns The id of the new texture.
+    virtual uint32_t create_target(sizei32x w, sizei32y h) = 0;
+
+    //! Direct drawing to the texture @p id, as returned by create_target, or
+    //! back to the window for screen_target. A texture is cleared to
+    //! transparent when it becomes the target; while it is, the transform and
+    //! clip rect are reset, and on returning to the window both are restored.
+    virtual void set_target(uint32_t id) = 0;
+
+    //! Incremented each time the contents of every target have been lost (as
+    //! can happen with some backends when the window is resized, for example)
+    //! and so need to be drawn again.
+    virtual uint32_t target_generation() const noexcept = 0;
+
+    virtual stats_t stats() const noexcept = 0;
+
+    //! Enable or disable submitting all the tiles of each call to draw_tiles
+    //! at once, rather than one at a time; enabled by default where supported.
+    //! @returns Whether batching is now in effect.
+    virtual bool set_batching(bool enabled) noexcept = 0;
+
+    //! Whether the renderer may be used from a thread other than the one which
+    //! made it; by one thread at a time.
+    virtual bool allows_any_thread() const noexcept = 0;
 };
 
 std::unique_ptr<renderer2d> make_renderer(system& sys);
@@ -295,6 +337,15 @@ public:
 
     virtual ~render_task();
     virtual void render(duration_t delta, renderer2d& r, view const& v) = 0;
+
+    //! Changes whenever anything the task draws does. While it is unchanged
+    //! the task draws the same as it did last time, given the same view and
+    //! window, unless it is animating.
+    virtual uint32_t generation() const noexcept = 0;
+
+    //! Whether the task would draw something different if rendered again
+    //! with nothing else changed; e.g. part way through a fade.
+    virtual bool is_animating() const noexcept { return false; }
 };
 
 //=====--------------------------------------------------------------------=====
@@ -401,7 +452,41 @@ public:
 
     virtual ~game_renderer();
 
-    virtual void render(duration_t delta, view const& v) const noexcept = 0;
+    //! Counts for the last frame presented, and the time spent recording and
+    //! then drawing it (but not presenting it).
+    struct frame_stats_t {
+        renderer2d::stats_t counts;
+        duration_t          time;
+    };
+
+    //! The number of frames drawn, and those skipped as nothing had changed.
+    struct frame_counts_t {
+        uint64_t drawn;
+        uint64_t skipped;
+    };
+
+    //! Render a frame of every task and present it. Where the renderer allows
+    //! it, the frame is recorded and then drawn by a thread of its own while
+    //! the caller carries on; otherwise it's drawn directly before returning.
+    //!
+    //! Nothing is done unless a task has changed (@see render_task::generation)
+    //! or is animating, or the view, window or render targets have changed
+    //! since the last frame.
+    //! @returns true if a frame was drawn; otherwise false.
+    virtual bool render(duration_t delta, view const& v) const noexcept = 0;
+
+    //! Block until the last frame rendered has been presented.
+    virtual void wait() const noexcept = 0;
+
+    virtual frame_stats_t frame_stats() const noexcept = 0;
+
+    virtual frame_counts_t frame_counts() const noexcept = 0;
+
+    //! Whether any task is animating; @see render_task::is_animating
+    virtual bool is_animating() const noexcept = 0;
+
+    //! @see renderer2d::set_batching
+    virtual bool set_batching(bool enabled) noexcept = 0;
 
     template <typename T>
     T& add_task(
@@ -423,4 +508,7 @@ public:
 std::unique_ptr<game_renderer>
 make_game_renderer(system& os, text_renderer& trender);
 
+std::unique_ptr<game_renderer>
+make_game_renderer(std::unique_ptr<renderer2d> r, text_renderer& trender);
+
 } //namespace boken
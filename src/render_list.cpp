@@ -0,0 +1,300 @@
+#include "render_list.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace boken {
+
+render_list::render_list(renderer2d& r, std::function<void ()> sync)
+  : r_    {r}
+  , sync_ {std::move(sync)}
+{
+}
+
+void render_list::reset(recti32 const client_rect) noexcept {
+    commands_.clear();
+    rects_.clear();
+    rect_colors_.clear();
+    positions_.clear();
+    tex_coords_.clear();
+    tex_sizes_.clear();
+    tile_colors_.clear();
+
+    client_rect_ = client_rect;
+    trans_       = transform_t {1.0f, 1.0f, 0.0f, 0.0f};
+    clip_rect_   = recti32 {};
+    tiles_       = 0;
+    on_target_   = false;
+}
+
+render_list::command& render_list::push_(op const code) {
+    commands_.push_back(command {code, 0, false, 0, sizei32x {}, sizei32y {}, 0, 0
+                               , recti32 {}, transform_t {1.0f, 1.0f, 0.0f, 0.0f}});
+    return commands_.back();
+}
+
+void render_list::replay() const {
+    using ptr_t = read_only_pointer_t;
+
+    auto const range = [](auto const& v, command const& c) noexcept {
+        return ptr_t {v.data() + c.first, v.data() + c.first + c.count};
+    };
+
+    for (auto const& c : commands_) {
+        auto const rects = rects_.data() + c.first;
+        auto const cols  = rect_colors_.data() + c.first;
+
+        switch (c.code) {
+        case op::set_clip_rect :   r_.set_clip_rect(c.rect);  break;
+        case op::reset_clip_rect : r_.clip_rect();            break;
+        case op::set_transform :   r_.set_transform(c.trans); break;
+        case op::clear :           r_.render_clear();         break;
+        case op::background :      r_.draw_background();      break;
+        case op::set_target :      r_.set_target(c.id);       break;
+        case op::fill_rects :
+            if (c.uniform) {
+                r_.fill_rects(rects, rects + c.count, *cols);
+            } else {
+                r_.fill_rects(rects, rects + c.count, cols, cols + c.count);
+            }
+            break;
+        case op::draw_rects :
+            if (c.uniform) {
+                r_.draw_rects(rects, rects + c.count, *cols, c.border);
+            } else {
+                r_.draw_rects(rects, rects + c.count, cols, cols + c.count, c.border);
+            }
+            break;
+        case op::tiles_uniform :
+            r_.draw_tiles(tile_params_uniform {
+                c.tile_w, c.tile_h, c.id, static_cast<int32_t>(c.count)
+              , range(positions_, c), range(tex_coords_, c), range(tile_colors_, c)});
+            break;
+        case op::tiles_variable :
+            r_.draw_tiles(tile_params_variable {
+                c.id, static_cast<int32_t>(c.count)
+              , range(positions_, c), range(tex_coords_, c)
+              , range(tex_sizes_, c), range(tile_colors_, c)});
+            break;
+        default:
+            BK_ASSERT(false);
+            break;
+        }
+    }
+}
+
+void render_list::set_clip_rect(recti32 const r) {
+    if (r == recti32 {}) {
+        clip_rect();
+        return;
+    }
+
+    push_(op::set_clip_rect).rect = r;
+    clip_rect_ = r;
+}
+
+renderer2d::undo_clip_rect render_list::clip_rect(recti32 const r) {
+    auto const prev = clip_rect_;
+    set_clip_rect(r);
+    return {*this, prev};
+}
+
+void render_list::clip_rect() {
+    push_(op::reset_clip_rect);
+    clip_rect_ = recti32 {};
+}
+
+void render_list::set_transform(transform_t const t) {
+    push_(op::set_transform).trans = t;
+    trans_ = t;
+}
+
+renderer2d::undo_transform render_list::transform(transform_t const t) {
+    auto const prev = trans_;
+    set_transform(t);
+    return {*this, prev};
+}
+
+void render_list::transform() {
+    transform({1.0f, 1.0f, 0.0f, 0.0f}).dismiss();
+}
+
+void render_list::render_clear() {
+    push_(op::clear);
+}
+
+void render_list::render_present() {
+    // presenting is up to whoever replays the list
+}
+
+void render_list::push_rects_(
+    op              const code
+  , recti32  const* const r_first
+  , recti32  const* const r_last
+  , uint32_t const* const c_first
+  , uint32_t        const color
+  , int32_t         const border
+) {
+    auto& c = push_(code);
+    c.uniform = !c_first;
+    c.border  = border;
+    c.first   = rects_.size();
+
+    rects_.insert(end(rects_), r_first, r_last);
+    c.count = rects_.size() - c.first;
+
+    if (c_first) {
+        rect_colors_.insert(end(rect_colors_), c_first, c_first + c.count);
+    } else {
+        rect_colors_.resize(rects_.size(), color);
+    }
+}
+
+void render_list::fill_rect(recti32 const r, uint32_t const color) {
+    fill_rects(&r, &r + 1, color);
+}
+
+void render_list::fill_rects(
+    recti32  const* const r_first, recti32  const* const r_last
+  , uint32_t const* const c_first, uint32_t const* const c_last
+) {
+    BK_ASSERT(std::distance(r_first, r_last)
+           == std::distance(c_first, c_last));
+
+    push_rects_(op::fill_rects, r_first, r_last, c_first, 0u, 0);
+}
+
+void render_list::fill_rects(
+    recti32  const* const r_first, recti32  const* const r_last
+  , uint32_t const color
+) {
+    push_rects_(op::fill_rects, r_first, r_last, nullptr, color, 0);
+}
+
+void render_list::draw_rect(recti32 const r, int32_t const border_size, uint32_t const color) {
+    draw_rects(&r, &r + 1, color, border_size);
+}
+
+void render_list::draw_rects(
+    recti32  const* const r_first, recti32  const* const r_last
+  , uint32_t const* const c_first, uint32_t const* const c_last
+  , int32_t  const border_size
+) {
+    BK_ASSERT(std::distance(r_first, r_last)
+           == std::distance(c_first, c_last));
+
+    push_rects_(op::draw_rects, r_first, r_last, c_first, 0u, border_size);
+}
+
+void render_list::draw_rects(
+    recti32  const* const r_first, recti32  const* const r_last
+  , uint32_t const color
+  , int32_t  const border_size
+) {
+    push_rects_(op::draw_rects, r_first, r_last, nullptr, color, border_size);
+}
+
+void render_list::draw_background() {
+    push_(op::background);
+}
+
+void render_list::draw_tiles(tile_params_uniform const& p) {
+    BK_ASSERT(p.count >= 0);
+
+    auto& c = push_(op::tiles_uniform);
+    c.id     = p.texture_id;
+    c.tile_w = p.tile_w;
+    c.tile_h = p.tile_h;
+    c.first  = positions_.size();
+    c.count  = static_cast<size_t>(p.count);
+
+    auto p_xy = p.pos_coords;
+    auto p_st = p.tex_coords;
+    auto p_c  = p.colors;
+
+    for (size_t i = 0; i < c.count; ++i, ++p_xy, ++p_st, ++p_c) {
+        positions_.push_back(p_xy.value<point2i16>());
+        tex_coords_.push_back(p_st.value<point2i16>());
+        tile_colors_.push_back(p_c.value<uint32_t>());
+    }
+
+    // every tile has a size so that the data of each is at the same index
+    tex_sizes_.resize(positions_.size());
+
+    tiles_ += static_cast<uint32_t>(c.count);
+}
+
+void render_list::draw_tiles(tile_params_variable const& p) {
+    BK_ASSERT(p.count >= 0);
+
+    auto& c = push_(op::tiles_variable);
+    c.id    = p.texture_id;
+    c.first = positions_.size();
+    c.count = static_cast<size_t>(p.count);
+
+    auto p_xy = p.pos_coords;
+    auto p_st = p.tex_coords;
+    auto p_wh = p.tex_sizes;
+    auto p_c  = p.colors;
+
+    for (size_t i = 0; i < c.count; ++i, ++p_xy, ++p_st, ++p_wh, ++p_c) {
+        positions_.push_back(p_xy.value<point2i16>());
+        tex_coords_.push_back(p_st.value<point2i16>());
+        tex_sizes_.push_back(p_wh.value<point2i16>());
+        tile_colors_.push_back(p_c.value<uint32_t>());
+    }
+
+    tiles_ += static_cast<uint32_t>(c.count);
+}
+
+bool render_list::has_targets() const noexcept {
+    return r_.has_targets();
+}
+
+uint32_t render_list::create_target(sizei32x const w, sizei32y const h) {
+    sync_();
+    return r_.create_target(w, h);
+}
+
+void render_list::set_target(uint32_t const id) {
+    auto const to_screen = (id == screen_target);
+
+    if (to_screen && !on_target_) {
+        return;
+    }
+
+    push_(op::set_target).id = id;
+
+    // the same changes to the state as the renderer will make on replay
+    if (!on_target_) {
+        screen_trans_ = trans_;
+        screen_clip_  = clip_rect_;
+    }
+
+    on_target_ = !to_screen;
+
+    if (to_screen) {
+        trans_     = screen_trans_;
+        clip_rect_ = screen_clip_;
+    } else {
+        trans_     = transform_t {1.0f, 1.0f, 0.0f, 0.0f};
+        clip_rect_ = recti32 {};
+    }
+}
+
+uint32_t render_list::target_generation() const noexcept {
+    return r_.target_generation();
+}
+
+renderer2d::stats_t render_list::stats() const noexcept {
+    return {static_cast<uint32_t>(commands_.size()), tiles_, 0u};
+}
+
+bool render_list::set_batching(bool const enabled) noexcept {
+    sync_();
+    return r_.set_batching(enabled);
+}
+
+} //namespace boken
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "render.hpp"
+
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace boken {
+
+//=====--------------------------------------------------------------------=====
+// A renderer2d which records what is drawn to it, copying any data it's given,
+// so that it can be replayed later onto another renderer; perhaps by another
+// thread while the next frame is being recorded.
+//
+// Textures which can be drawn to are made by the renderer replayed onto, and
+// so must exist before the commands which use them are replayed. To allow
+// this, create_target invokes the sync function given at construction (which
+// is to wait until no replay is in progress), then forwards to that renderer.
+//=====--------------------------------------------------------------------=====
+class render_list final : public renderer2d {
+public:
+    render_list(renderer2d& r, std::function<void ()> sync);
+
+    //! Discard everything recorded, and reset the transform and clip rect.
+    //! @p client_rect is returned by get_client_rect until the next reset.
+    void reset(recti32 client_rect) noexcept;
+
+    //! Draw everything recorded onto the renderer given at construction.
+    void replay() const;
+
+    //! The number of commands recorded.
+    size_t size() const noexcept { return commands_.size(); }
+
+    //---renderer2d interface
+    recti32 get_client_rect() const final override {
+        return client_rect_;
+    }
+
+    void set_clip_rect(recti32 r) final override;
+    undo_clip_rect clip_rect(recti32 r) final override;
+    void clip_rect() final override;
+
+    void set_transform(transform_t t) final override;
+    undo_transform transform(transform_t t) final override;
+    void transform() final override;
+
+    void render_clear() final override;
+    void render_present() final override;
+
+    void fill_rect(recti32 r, uint32_t color) final override;
+
+    void fill_rects(
+        recti32  const* r_first, recti32  const* r_last
+      , uint32_t const* c_first, uint32_t const* c_last) final override;
+
+    void fill_rects(
+        recti32  const* r_first, recti32  const* r_last
+      , uint32_t color) final override;
+
+    void draw_rect(recti32 r, int32_t border_size, uint32_t color) final override;
+
+    void draw_rects(
+        recti32  const* r_first, recti32  const* r_last
+      , uint32_t const* c_first, uint32_t const* c_last
+      , int32_t  border_size
+    ) final override;
+
+    void draw_rects(
+        recti32  const* r_first, recti32  const* r_last
+      , uint32_t color
+      , int32_t  border_size
+    ) final override;
+
+    void draw_background() final override;
+
+    void draw_tiles(tile_params_uniform  const& params) final override;
+    void draw_tiles(tile_params_variable const& params) final override;
+
+    bool has_targets() const noexcept final override;
+    uint32_t create_target(sizei32x w, sizei32y h) final override;
+    void set_target(uint32_t id) final override;
+    uint32_t target_generation() const noexcept final override;
+
+    //! The number of commands and tiles recorded; nothing is drawn, and so
+    //! there are no changes of state.
+    stats_t stats() const noexcept final override;
+
+    //! Syncs, then forwards to the renderer given at construction.
+    bool set_batching(bool enabled) noexcept final override;
+
+    bool allows_any_thread() const noexcept final override {
+        return true;
+    }
+private:
+    enum class op : uint32_t {
+        set_clip_rect, reset_clip_rect, set_transform, clear, fill_rects
+      , draw_rects, background, tiles_uniform, tiles_variable, set_target
+    };
+
+    struct command {
+        op          code;
+        uint32_t    id;       //!< texture or target
+        bool        uniform;  //!< rects of the same color
+        int32_t     border;
+        sizei32x    tile_w;
+        sizei32y    tile_h;
+        size_t      first;    //!< into the data for the command
+        size_t      count;
+        recti32     rect;
+        transform_t trans;
+    };
+
+    command& push_(op code);
+
+    //! Record rects colored by @p c_first, or all @p color if it's nullptr.
+    void push_rects_(op code, recti32 const* r_first, recti32 const* r_last
+                   , uint32_t const* c_first, uint32_t color, int32_t border);
+
+    renderer2d&            r_;
+    std::function<void ()> sync_;
+
+    std::vector<command>   commands_;
+
+    // the data of the commands; rects, and tiles, by index
+    std::vector<recti32>   rects_;
+    std::vector<uint32_t>  rect_colors_;
+    std::vector<point2i16> positions_;
+    std::vector<point2i16> tex_coords_;
+    std::vector<point2i16> tex_sizes_;
+    std::vector<uint32_t>  tile_colors_;
+
+    recti32     client_rect_;
+    transform_t trans_ {1.0f, 1.0f, 0.0f, 0.0f};
+    recti32     clip_rect_;
+    uint32_t    tiles_ {};
+
+    // the state of the window while drawing to a target; see set_target
+    transform_t screen_trans_ {1.0f, 1.0f, 0.0f, 0.0f};
+    recti32     screen_clip_;
+    bool        on_target_ {false};
+};
+
+} //namespace boken
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "bkassert/assert.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace boken {
+
+//! Counters describing the work done by an actor_scheduler.
+struct scheduler_stats {
+    uint64_t now;             //!< the current time of the scheduler
+    uint32_t scheduled;       //!< the number of actors currently scheduled
+    uint32_t activated;       //!< actors activated by the last advance
+    uint32_t discarded;       //!< stale entries dropped by the last advance
+    uint64_t total_activated; //!< actors activated over the scheduler lifetime
+};
+
+//! A discrete event scheduler for actors keyed by the time of their next
+//! action. Each call to advance() moves the clock forward and activates, in
+//! time order, only those actors whose time has come; an actor which isn't
+//! scheduled (asleep) or is scheduled far in the future costs nothing.
+//!
+//! Actors due within the next wheel_size ticks are kept in a timing wheel with
+//! one bucket per tick; actors due further out wait in a min-heap and are moved
+//! onto the wheel as their time approaches.
+//!
+//! Rescheduling and unscheduling don't search for the existing entry; instead
+//! each actor has a token identifying its current entry and any other entries
+//! for the same actor are discarded lazily when they come due.
+template <typename Id, typename Hash = std::hash<Id>>
+class actor_scheduler {
+public:
+    using id_type   = Id;
+    using time_type = uint64_t;
+
+    static constexpr time_type wheel_size = 2048;
+
+    actor_scheduler()
+      : wheel_(wheel_size)
+    {
+    }
+
+    time_type now()   const noexcept { return now_; }
+    size_t    size()  const noexcept { return tokens_.size(); }
+    bool      empty() const noexcept { return tokens_.empty(); }
+
+    bool is_scheduled(id_type const id) const noexcept {
+        return tokens_.find(id) != end(tokens_);
+    }
+
+    scheduler_stats stats() const noexcept {
+        return {now_
+              , static_cast<uint32_t>(tokens_.size())
+              , activated_
+              , discarded_
+              , total_activated_};
+    }
+
+    //! Schedule @p id to act @p delay ticks from now, replacing any existing
+    //! schedule for @p id. A delay of 0 means the actor acts during the next
+    //! call to advance().
+    void schedule(id_type const id, time_type const delay) {
+        // entries are processed for the ticks (now, now + dt], so an actor due
+        // "now" is placed on the next tick.
+        schedule_at_(id, now_ + std::max(delay, time_type {1}));
+    }
+
+    //! Put @p id to sleep; it won't act again until it is rescheduled.
+    //! @returns true if @p id was scheduled, false otherwise.
+    bool unschedule(id_type const id) noexcept {
+        return tokens_.erase(id) > 0;
+    }
+
+    //! Forget all actors, but keep the current time.
+    void clear() noexcept {
+        for (auto& bucket : wheel_) {
+            bucket.clear();
+        }
+        far_.clear();
+        tokens_.clear();
+    }
+
+    //! Schedule @p id to act at the absolute time @p time, replacing any
+    //! existing schedule for @p id. A time at or before now() is treated as
+    //! the next tick.
+    void schedule_at(id_type const id, time_type const time) {
+        schedule_at_(id, std::max(time, now_ + 1));
+    }
+
+    //! Advance the clock by @p dt and activate every actor whose time is at or
+    //! before the new time.
+    //! @param f A function of the form f(id_type) -> time_type returning the
+    //!          delay until the actor acts next relative to the time it was
+    //!          due, or 0 to put the actor to sleep. Actors can be scheduled
+    //!          and unscheduled from within @p f.
+    //! @returns The number of actors activated.
+    template <typename UnaryF>
+    uint32_t advance(time_type const dt, UnaryF f) {
+        return advance_(dt, [&](entry const& e) {
+            activate_(e, f);
+        });
+    }
+
+    //! As advance(), but rather than activating actors, append each to @p out
+    //! as a pair (id, time due) in the order they would have been activated.
+    //! The actors are left unscheduled; the caller reschedules them with
+    //! schedule_at().
+    //! @returns The number of actors taken.
+    template <typename Container>
+    uint32_t take_due(time_type const dt, Container& out) {
+        return advance_(dt, [&](entry const& e) {
+            auto const it = tokens_.find(e.id);
+            if (it == end(tokens_) || it->second != e.token) {
+                ++discarded_;
+                return;
+            }
+
+            ++activated_;
+            tokens_.erase(it);
+            out.push_back({e.id, e.time});
+        });
+    }
+private:
+    struct entry {
+        time_type time;
+        uint64_t  token;
+        id_type   id;
+    };
+
+    template <typename UnaryF>
+    uint32_t advance_(time_type const dt, UnaryF on_due) {
+        activated_ = 0;
+        discarded_ = 0;
+
+        for (auto const last = now_ + dt; now_ < last; ) {
+            auto const t = ++now_;
+
+            // move any entries which are now within range of the wheel
+            while (!far_.empty() && far_.front().time < t + wheel_size) {
+                std::pop_heap(begin(far_), end(far_), predicate_);
+                wheel_[far_.back().time % wheel_size].push_back(far_.back());
+                far_.pop_back();
+            }
+
+            // anything scheduled while walking the bucket is at least one tick
+            // out and anything a whole turn of the wheel out goes to far_, so
+            // the bucket for this tick isn't modified while it is walked.
+            auto& bucket = wheel_[t % wheel_size];
+            for (auto const& e : bucket) {
+                BK_ASSERT(e.time == t);
+                on_due(e);
+            }
+
+            bucket.clear();
+        }
+
+        total_activated_ += activated_;
+
+        return activated_;
+    }
+
+    template <typename UnaryF>
+    void activate_(entry const e, UnaryF& f) {
+        auto const it = tokens_.find(e.id);
+        if (it == end(tokens_) || it->second != e.token) {
+            ++discarded_;
+            return;
+        }
+
+        ++activated_;
+
+        auto const delay = f(e.id);
+
+        // the callback may have rescheduled or removed the actor
+        auto const it_after = tokens_.find(e.id);
+        if (it_after == end(tokens_) || it_after->second != e.token) {
+            return;
+        }
+
+        if (delay == 0) {
+            tokens_.erase(it_after);
+        } else {
+            it_after->second = push_(e.time + delay, e.id);
+        }
+    }
+
+    void schedule_at_(id_type const id, time_type const time) {
+        tokens_[id] = push_(time, id);
+    }
+
+    //! @returns the token of the new entry.
+    uint64_t push_(time_type const time, id_type const id) {
+        BK_ASSERT(time > now_);
+
+        auto const token = next_token_++;
+
+        if (time - now_ < wheel_size) {
+            wheel_[time % wheel_size].push_back({time, token, id});
+        } else {
+            far_.push_back({time, token, id});
+            std::push_heap(begin(far_), end(far_), predicate_);
+        }
+
+        return token;
+    }
+
+    //! a min heap on time; ties are broken by the order they were scheduled.
+    static bool predicate_(entry const& a, entry const& b) noexcept {
+        return (a.time > b.time)
+            || (a.time == b.time && a.token > b.token);
+    }
+
+    std::vector<std::vector<entry>>             wheel_;
+    std::vector<entry>                          far_;
+    std::unordered_map<id_type, uint64_t, Hash> tokens_;
+
+    time_type now_             = 0;
+    uint64_t  next_token_      = 0;
+    uint32_t  activated_       = 0;
+    uint32_t  discarded_       = 0;
+    uint64_t  total_activated_ = 0;
+};
+
+} //namespace boken
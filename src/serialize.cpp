@@ -14,6 +14,7 @@
 #include <rapidjson/filereadstream.h>
 
 #include <string>
+#include <vector>
 #include <cstdint>
 
 namespace boken {
@@ -665,15 +666,124 @@ bool entity_definition_handler::run() {
 
 namespace {
 
-template <typename Handler, typename Finish, typename Property>
+enum class behavior_definition_handler_state {
+    start
+  ,   type, type_value
+  ,   data, data_start
+  ,     behavior_id_or_end
+  ,     behavior_id, behavior_start
+  ,       rule_or_end
+  ,   data_end
+  , end
+};
+
+} // namespace
+
+class behavior_definition_handler
+    : public definition_handler_base<behavior_definition_handler
+                                   , behavior_definition_handler_state>
+{
+public:
+    using state_type = definition_handler_base::state_type;
+
+    explicit behavior_definition_handler(
+        on_finish_behavior_definition const& on_finish
+    ) : on_finish_ {on_finish}
+    {
+    }
+
+    void set_current_state(state_type const state) noexcept {
+        state_ = state;
+    }
+
+    bool run();
+private:
+    on_finish_behavior_definition const& on_finish_;
+
+    std::string              id_;
+    std::vector<std::string> rules_;
+
+    state_type state_ {state_type::start};
+};
+
+bool behavior_definition_handler::run() {
+    using st = state_type;
+    using et = element_type;
+
+    for (;;) switch (state_) {
+    case st::start:
+        return transition(et::obj_start
+                        , st::type);
+    case st::type:
+        return transition(et::obj_key
+                        , last_string_hash_
+                        , djb2_hash_32c("type")
+                        , st::type_value);
+    case st::type_value:
+        return transition(et::string
+                        , last_string_hash_
+                        , djb2_hash_32c("behaviors")
+                        , st::data);
+    case st::data:
+        return transition(et::obj_key
+                        , last_string_hash_
+                        , djb2_hash_32c("data")
+                        , st::data_start);
+    case st::data_start:
+        return transition(et::obj_start
+                        , st::behavior_id_or_end);
+    case st::behavior_id_or_end:
+        if (last_type_ == et::obj_key) {
+            state_ = st::behavior_id;
+            continue;
+        } else if (last_type_ == et::obj_end) {
+            state_ = st::data_end;
+            continue;
+        }
+
+        return false;
+    case st::behavior_id:
+        return transition(et::obj_key, st::behavior_start, [&] {
+            id_ = last_string_;
+        });
+    case st::behavior_start:
+        return transition(et::arr_start
+                        , st::rule_or_end);
+    case st::rule_or_end:
+        if (last_type_ == et::string) {
+            rules_.push_back(last_string_);
+            return true;
+        }
+
+        return transition(et::arr_end
+                        , st::behavior_id_or_end
+                        , [&] {
+                              on_finish_(id_, rules_);
+                              id_.clear();
+                              rules_.clear();
+                          });
+    case st::data_end:
+        return transition(et::obj_end
+                        , st::end);
+    case st::end:
+        return transition(et::obj_end
+                        , st::start);
+    default:
+        BK_ASSERT(false);
+        return false;
+    }
+}
+
+namespace {
+
+template <typename Handler, typename... Callbacks>
 void impl_load_definitions_(
     string_view const filename
-  , Finish   const& on_finish
-  , Property const& on_property
+  , Callbacks const&... callbacks
 ) {
     constexpr size_t buffer_size = 65536;
 
-    Handler handler {on_finish, on_property};
+    Handler handler {callbacks...};
 
     rapidjson::Reader reader {nullptr};
     char buffer[buffer_size];
@@ -713,4 +823,11 @@ void load_entity_definitions(
         "./data/entities.dat", on_finish, on_property);
 }
 
+void load_behavior_definitions(
+    on_finish_behavior_definition const& on_finish
+) {
+    impl_load_definitions_<behavior_definition_handler>(
+        "./data/behaviors.dat", on_finish);
+}
+
 } //namespace boken
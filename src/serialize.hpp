@@ -2,6 +2,8 @@
 
 #include "config.hpp"
 #include <functional>
+#include <string>
+#include <vector>
 #include <cstdint>
 #include <cstddef>
 
@@ -29,6 +31,10 @@ using on_finish_entity_definition = std::function<
 
 using on_add_new_entity_property = on_add_new_item_property;
 
+//! Invoked for each behavior with its id and the source of its rules.
+using on_finish_behavior_definition = std::function<
+    void (string_view id, std::vector<std::string> const& rules)>;
+
 void load_item_definitions(
     on_finish_item_definition const& on_finish
   , on_add_new_item_property  const& on_property
@@ -39,6 +45,10 @@ void load_entity_definitions(
   , on_add_new_entity_property  const& on_property
 );
 
+void load_behavior_definitions(
+    on_finish_behavior_definition const& on_finish
+);
+
 uint32_t to_property(std::nullptr_t n) noexcept;
 uint32_t to_property(bool n) noexcept;
 uint32_t to_property(int32_t n) noexcept;
@@ -0,0 +1,628 @@
+#include "software_renderer.hpp"
+#include "math.hpp"
+
+#include "bkassert/assert.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define BK_SOFTWARE_RENDERER_SSE2 1
+#   include <emmintrin.h>
+#else
+#   define BK_SOFTWARE_RENDERER_SSE2 0
+#endif
+
+namespace boken {
+
+software_renderer::~software_renderer() = default;
+
+namespace {
+
+//! a * b / 255 rounded to the nearest integer; exact for a, b in [0, 255].
+constexpr uint32_t mul255(uint32_t const a, uint32_t const b) noexcept {
+    return ((a * b + 128u) + ((a * b + 128u) >> 8)) >> 8;
+}
+
+//! Modulate the color of @p src by @p mod, then blend it over @p dst.
+uint32_t blend_pixel(uint32_t const src, uint32_t const dst, uint32_t const mod) noexcept {
+    auto const channel = [](uint32_t const c, int const shift) noexcept {
+        return (c >> shift) & 0xFFu;
+    };
+
+    auto const sa  = channel(src, 24);
+    auto const inv = 255u - sa;
+
+    uint32_t result = (sa + mul255(channel(dst, 24), inv)) << 24;
+
+    for (int shift = 0; shift < 24; shift += 8) {
+        auto const c = mul255(channel(src, shift), channel(mod, shift));
+        result |= (mul255(c, sa) + mul255(channel(dst, shift), inv)) << shift;
+    }
+
+    return result;
+}
+
+#if BK_SOFTWARE_RENDERER_SSE2
+//! mul255 for each of 8 lanes of 16 bits.
+inline __m128i mul255_epi16(__m128i const a, __m128i const b) noexcept {
+    auto const t = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+//! blend_pixel for two pixels, widened to 16 bits per channel.
+inline __m128i blend_epi16(__m128i const src, __m128i const dst, __m128i const mod) noexcept {
+    auto const s = mul255_epi16(src, mod); // mod is 255 for alpha
+
+    // the alpha of each pixel in each of its lanes
+    auto const a = _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+    // ... except the alpha lane itself, which is added as is
+    auto const keep_rgb = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    auto const one_a    = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    auto const sa       = _mm_or_si128(_mm_and_si128(a, keep_rgb), one_a);
+
+    auto const inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+
+    return _mm_add_epi16(mul255_epi16(s, sa), mul255_epi16(dst, inv));
+}
+#endif
+
+//! dst[i] = blend_pixel(src[i], dst[i], mod) for each i in [0, n).
+void blend_span(
+    uint32_t*       const dst
+  , uint32_t const* const src
+  , size_t          const n
+  , uint32_t        const mod
+) noexcept {
+    size_t i = 0;
+
+#if BK_SOFTWARE_RENDERER_SSE2
+    auto const zero = _mm_setzero_si128();
+    auto const m    = _mm_unpacklo_epi8(
+        _mm_set1_epi32(static_cast<int>(mod | 0xFF000000u)), zero);
+
+    for (; i + 4u <= n; i += 4u) {
+        auto const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        auto const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + i));
+
+        auto const lo = blend_epi16(
+            _mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), m);
+        auto const hi = blend_epi16(
+            _mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), m);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i)
+                       , _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < n; ++i) {
+        dst[i] = blend_pixel(src[i], dst[i], mod);
+    }
+}
+
+struct texture_t {
+    int32_t               width;
+    int32_t               height;
+    std::vector<uint32_t> pixels;
+    uint32_t              color_mod {0xFFFFFFFFu}; //!< see note_tile_state_
+};
+
+//! The pixels, along one axis, whose centers fall within [x, x + w) once
+//! scaled by s.
+std::pair<int32_t, int32_t> to_device(
+    int32_t const x
+  , int32_t const w
+  , float   const s
+) noexcept {
+    return {ceil_as<int32_t>(static_cast<float>(x)     * s - 0.5f)
+          , ceil_as<int32_t>(static_cast<float>(x + w) * s - 0.5f)};
+}
+
+} // namespace
+
+class software_renderer_impl final : public software_renderer {
+public:
+    software_renderer_impl(sizei32x const w, sizei32y const h) {
+        resize(w, h);
+    }
+
+    //---software_renderer interface
+    uint32_t add_texture(
+        sizei32x const w
+      , sizei32y const h
+      , std::vector<uint32_t> pixels
+    ) final override {
+        BK_ASSERT(value_cast(w) >= 0 && value_cast(h) >= 0
+               && pixels.size() == static_cast<size_t>(value_cast(w) * value_cast(h)));
+
+        textures_.push_back({value_cast(w), value_cast(h), std::move(pixels)});
+        return static_cast<uint32_t>(textures_.size() - 1u);
+    }
+
+    void set_background(uint32_t const texture_id) noexcept final override {
+        BK_ASSERT(texture_id < textures_.size());
+        background_ = texture_id;
+    }
+
+    void resize(sizei32x const w, sizei32y const h) final override {
+        BK_ASSERT(value_cast(w) >= 0 && value_cast(h) >= 0);
+
+        screen_.width  = value_cast(w);
+        screen_.height = value_cast(h);
+        screen_.pixels.clear();
+        screen_.pixels.resize(static_cast<size_t>(screen_.width * screen_.height));
+    }
+
+    bool enable_targets(bool const enabled) noexcept final override {
+        auto const result = targets_enabled_;
+        targets_enabled_ = enabled;
+        return result;
+    }
+
+    std::vector<uint32_t> const& pixels() const noexcept final override {
+        return screen_.pixels;
+    }
+
+    //---renderer2d interface
+    recti32 get_client_rect() const final override {
+        return {point2i32 {}, sizei32x {screen_.width}, sizei32y {screen_.height}};
+    }
+
+    void set_clip_rect(recti32 const r) final override {
+        clip_rect_ = r;
+    }
+
+    undo_clip_rect clip_rect(recti32 const r) final override {
+        auto const prev = clip_rect_;
+        set_clip_rect(r);
+        return {*this, prev};
+    }
+
+    void clip_rect() final override {
+        clip_rect_ = recti32 {};
+    }
+
+    void set_transform(transform_t const t) final override {
+        trans_ = t;
+    }
+
+    undo_transform transform(transform_t const t) final override {
+        auto const prev = trans_;
+        set_transform(t);
+        return {*this, prev};
+    }
+
+    void transform() final override {
+        transform({1.0f, 1.0f, 0.0f, 0.0f}).dismiss();
+    }
+
+    void render_clear() final override {
+        auto& t = target_();
+        std::fill(begin(t.pixels), end(t.pixels), 0xFF007F7Fu);
+        stats_ = stats_t {};
+    }
+
+    void render_present() final override {
+    }
+
+    void fill_rect(recti32 const r, uint32_t const color) final override {
+        fill_rects(&r, &r + 1, color);
+    }
+
+    void fill_rects(
+        recti32  const* const r_first, recti32  const* const r_last
+      , uint32_t const* const c_first, uint32_t const* const c_last
+    ) final override {
+        BK_ASSERT(std::distance(r_first, r_last)
+               == std::distance(c_first, c_last));
+
+        auto c = c_first;
+        for (auto it = r_first; it != r_last; ++it, ++c) {
+            fill_rect_(*it, *c);
+            ++stats_.draw_calls;
+        }
+    }
+
+    void fill_rects(
+        recti32  const* const r_first, recti32  const* const r_last
+      , uint32_t const color
+    ) final override {
+        for (auto it = r_first; it != r_last; ++it) {
+            fill_rect_(*it, color);
+            ++stats_.draw_calls;
+        }
+    }
+
+    void draw_rect(recti32 const r, int32_t const border_size, uint32_t const color) final override {
+        draw_rects(&r, &r + 1, color, border_size);
+    }
+
+    void draw_rects(
+        recti32  const* const r_first, recti32  const* const r_last
+      , uint32_t const color
+      , int32_t  const border_size
+    ) final override {
+        for (auto it = r_first; it != r_last; ++it) {
+            draw_rect_(*it, border_size, color);
+        }
+    }
+
+    void draw_rects(
+        recti32  const* const r_first, recti32  const* const r_last
+      , uint32_t const* const c_first, uint32_t const* const c_last
+      , int32_t  const border_size
+    ) final override {
+        BK_ASSERT(std::distance(r_first, r_last)
+               == std::distance(c_first, c_last));
+
+        auto c = c_first;
+        for (auto it = r_first; it != r_last; ++it, ++c) {
+            draw_rect_(*it, border_size, *c);
+        }
+    }
+
+    void draw_background() final override;
+
+    void draw_tiles(tile_params_uniform const& p) final override {
+        BK_ASSERT(p.count >= 0
+               && p.texture_id < textures_.size());
+
+        auto const tx = ceil_as<int32_t>(trans_.trans_x / trans_.scale_x);
+        auto const ty = ceil_as<int32_t>(trans_.trans_y / trans_.scale_y);
+        auto const w  = value_cast(p.tile_w);
+        auto const h  = value_cast(p.tile_h);
+
+        auto const& texture = textures_[p.texture_id];
+
+        auto p_xy = p.pos_coords;
+        auto p_st = p.tex_coords;
+        auto p_c  = p.colors;
+
+        for (int32_t i = 0; i < p.count; ++i, ++p_xy, ++p_st, ++p_c) {
+            auto const xy = p_xy.value<point2i16>();
+            auto const st = p_st.value<point2i16>();
+
+            auto const c  = p_c.value<uint32_t>();
+
+            note_tile_state_(p.texture_id, c);
+            draw_tile_(texture, value_cast(st.x), value_cast(st.y), w, h
+                     , value_cast(xy.x) + tx, value_cast(xy.y) + ty, c);
+        }
+
+        ++stats_.draw_calls;
+        stats_.tiles += static_cast<uint32_t>(p.count);
+    }
+
+    void draw_tiles(tile_params_variable const& p) final override {
+        BK_ASSERT(p.count >= 0
+               && p.texture_id < textures_.size());
+
+        auto const tx = ceil_as<int32_t>(trans_.trans_x / trans_.scale_x);
+        auto const ty = ceil_as<int32_t>(trans_.trans_y / trans_.scale_y);
+
+        auto const& texture = textures_[p.texture_id];
+
+        auto p_xy = p.pos_coords;
+        auto p_st = p.tex_coords;
+        auto p_wh = p.tex_sizes;
+        auto p_c  = p.colors;
+
+        for (int32_t i = 0; i < p.count; ++i, ++p_xy, ++p_st, ++p_wh, ++p_c) {
+            auto const xy = p_xy.value<point2i16>();
+            auto const st = p_st.value<point2i16>();
+            auto const wh = p_wh.value<point2i16>();
+            auto const c  = p_c.value<uint32_t>();
+
+            note_tile_state_(p.texture_id, c);
+            draw_tile_(texture, value_cast(st.x), value_cast(st.y)
+                     , value_cast(wh.x), value_cast(wh.y)
+                     , value_cast(xy.x) + tx, value_cast(xy.y) + ty, c);
+        }
+
+        ++stats_.draw_calls;
+        stats_.tiles += static_cast<uint32_t>(p.count);
+    }
+
+    bool has_targets() const noexcept final override {
+        return targets_enabled_;
+    }
+
+    uint32_t create_target(sizei32x const w, sizei32y const h) final override {
+        BK_ASSERT(has_targets());
+
+        auto const size = static_cast<size_t>(value_cast(w) * value_cast(h));
+        return add_texture(w, h, std::vector<uint32_t>(size, 0u));
+    }
+
+    void set_target(uint32_t const id) final override {
+        auto const to_screen = (id == screen_target);
+        BK_ASSERT(to_screen || id < textures_.size());
+
+        if (to_screen && target_id_ == screen_target) {
+            return;
+        }
+
+        if (target_id_ == screen_target) {
+            screen_trans_ = trans_;
+            screen_clip_  = clip_rect_;
+        }
+
+        target_id_ = id;
+
+        if (to_screen) {
+            set_transform(screen_trans_);
+            set_clip_rect(screen_clip_);
+            return;
+        }
+
+        transform();
+        clip_rect();
+
+        auto& t = target_();
+        std::fill(begin(t.pixels), end(t.pixels), 0u);
+    }
+
+    uint32_t target_generation() const noexcept final override {
+        return 0; // never lost
+    }
+
+    stats_t stats() const noexcept final override {
+        return stats_;
+    }
+
+    bool set_batching(bool) noexcept final override {
+        return false;
+    }
+
+    bool allows_any_thread() const noexcept final override {
+        return true;
+    }
+private:
+    texture_t& target_() noexcept {
+        return (target_id_ == screen_target)
+          ? screen_
+          : textures_[target_id_];
+    }
+
+    //! The pixels of the current target which the rect @p r (unscaled)
+    //! covers, limited to the clip rect.
+    recti32 device_rect_(int32_t x, int32_t y, int32_t w, int32_t h) noexcept;
+
+    //! Draw the texels of @p texture at (@p sx, @p sy) of size @p w x @p h to
+    //! the rect (unscaled) at (@p dx, @p dy).
+    void draw_tile_(texture_t const& texture
+                  , int32_t sx, int32_t sy, int32_t w, int32_t h
+                  , int32_t dx, int32_t dy
+                  , uint32_t color);
+
+    void fill_rect_(recti32 r, uint32_t color);
+    void draw_rect_(recti32 r, int32_t border_size, uint32_t color);
+
+    //! Count the changes of state a renderer with a current texture and color
+    //! mod (e.g. SDL, unbatched) would make to draw a tile of @p texture_id in
+    //! @p color. There is no such state here, but counting them lets the order
+    //! in which tiles are given be measured without a window.
+    void note_tile_state_(uint32_t texture_id, uint32_t color) noexcept;
+
+    texture_t              screen_;
+    std::vector<texture_t> textures_;
+    std::vector<uint32_t>  row_; //!< scratch for a row of scaled texels
+
+    uint32_t target_id_  {screen_target};
+    uint32_t background_ {screen_target};
+
+    transform_t trans_ {1.0f, 1.0f, 0.0f, 0.0f};
+    recti32     clip_rect_;
+
+    // the state of the window while drawing to a target; see set_target
+    transform_t screen_trans_ {1.0f, 1.0f, 0.0f, 0.0f};
+    recti32     screen_clip_;
+
+    stats_t  stats_           {};
+    uint32_t last_texture_    {screen_target}; //!< see note_tile_state_
+    bool     targets_enabled_ {true};
+};
+
+std::unique_ptr<software_renderer> make_software_renderer(
+    sizei32x const w
+  , sizei32y const h
+) {
+    return std::make_unique<software_renderer_impl>(w, h);
+}
+
+recti32 software_renderer_impl::device_rect_(
+    int32_t const x, int32_t const y
+  , int32_t const w, int32_t const h
+) noexcept {
+    auto const& t = target_();
+
+    auto const xs = to_device(x, w, trans_.scale_x);
+    auto const ys = to_device(y, h, trans_.scale_y);
+
+    auto x0 = std::max(0, xs.first);
+    auto y0 = std::max(0, ys.first);
+    auto x1 = std::min(t.width,  xs.second);
+    auto y1 = std::min(t.height, ys.second);
+
+    // the clip rect is scaled in the same way as everything else
+    if (clip_rect_ != recti32 {}) {
+        auto const cx = to_device(value_cast(clip_rect_.x0)
+                                , value_cast(clip_rect_.width()),  trans_.scale_x);
+        auto const cy = to_device(value_cast(clip_rect_.y0)
+                                , value_cast(clip_rect_.height()), trans_.scale_y);
+
+        x0 = std::max(x0, cx.first);
+        y0 = std::max(y0, cy.first);
+        x1 = std::min(x1, cx.second);
+        y1 = std::min(y1, cy.second);
+    }
+
+    if (x1 <= x0 || y1 <= y0) {
+        return recti32 {};
+    }
+
+    return {point2i32 {x0, y0}, point2i32 {x1, y1}};
+}
+
+void software_renderer_impl::draw_tile_(
+    texture_t const& texture
+  , int32_t  const sx, int32_t const sy
+  , int32_t  const w,  int32_t const h
+  , int32_t  const dx, int32_t const dy
+  , uint32_t const color
+) {
+    BK_ASSERT(sx >= 0 && sx + w <= texture.width
+           && sy >= 0 && sy + h <= texture.height);
+
+    auto const r = device_rect_(dx, dy, w, h);
+    if (r == recti32 {}) {
+        return;
+    }
+
+    auto& t = target_();
+
+    auto const x0 = value_cast(r.x0);
+    auto const y0 = value_cast(r.y0);
+    auto const x1 = value_cast(r.x1);
+    auto const y1 = value_cast(r.y1);
+    auto const n  = static_cast<size_t>(x1 - x0);
+
+    auto const dst_at = [&](int32_t const x, int32_t const y) noexcept {
+        return t.pixels.data() + static_cast<ptrdiff_t>(x + y * t.width);
+    };
+
+    auto const src_at = [&](int32_t const x, int32_t const y) noexcept {
+        return texture.pixels.data() + static_cast<ptrdiff_t>(x + y * texture.width);
+    };
+
+    // one pixel per texel; each row of texels is blended as is
+    auto const xs = to_device(dx, w, trans_.scale_x);
+    auto const ys = to_device(dy, h, trans_.scale_y);
+
+    if (xs.second - xs.first == w && ys.second - ys.first == h) {
+        for (auto y = y0; y < y1; ++y) {
+            blend_span(dst_at(x0, y)
+              , src_at(sx + x0 - xs.first, sy + y - ys.first), n, color);
+        }
+
+        return;
+    }
+
+    // scaled; each row is first sampled from the nearest texels
+    auto const texel = [](int32_t const p, float const s, int32_t const d, int32_t const size) noexcept {
+        auto const i = floor_as<int32_t>((static_cast<float>(p) + 0.5f) / s) - d;
+        return std::min(std::max(i, 0), size - 1);
+    };
+
+    row_.resize(n);
+
+    for (auto y = y0; y < y1; ++y) {
+        auto const src = src_at(sx, sy + texel(y, trans_.scale_y, dy, h));
+
+        for (auto x = x0; x < x1; ++x) {
+            row_[static_cast<size_t>(x - x0)] = src[texel(x, trans_.scale_x, dx, w)];
+        }
+
+        blend_span(dst_at(x0, y), row_.data(), n, color);
+    }
+}
+
+void software_renderer_impl::fill_rect_(recti32 const r, uint32_t const color) {
+    auto const d = device_rect_(value_cast(r.x0), value_cast(r.y0)
+                              , value_cast(r.width()), value_cast(r.height()));
+    if (d == recti32 {}) {
+        return;
+    }
+
+    auto& t = target_();
+
+    auto const n = static_cast<size_t>(value_cast(d.width()));
+    row_.assign(n, color);
+
+    for (auto y = value_cast(d.y0); y < value_cast(d.y1); ++y) {
+        auto const dst = t.pixels.data()
+          + static_cast<ptrdiff_t>(value_cast(d.x0) + y * t.width);
+
+        blend_span(dst, row_.data(), n, 0xFFFFFFFFu);
+    }
+}
+
+void software_renderer_impl::draw_rect_(
+    recti32  const r
+  , int32_t  const border_size
+  , uint32_t const color
+) {
+    auto const tx = ceil_as<int32_t>(trans_.trans_x / trans_.scale_x);
+    auto const ty = ceil_as<int32_t>(trans_.trans_y / trans_.scale_y);
+
+    auto const w  = border_size;
+    auto const w2 = 2 * w;
+    auto const h  = border_size;
+
+    auto const rw = r.width();
+    auto const rh = r.height();
+
+    auto const x0 = value_cast(r.x0) + tx;
+    auto const y0 = value_cast(r.y0) + ty;
+    auto const x1 = value_cast(r.x1) + tx;
+    auto const y1 = value_cast(r.y1) + ty;
+
+    // the same four rects as the SDL renderer
+    recti32 const rects[] {
+        {point2i32 {x0 + 0, y0 + 0}, sizei32x {w},       rh}
+      , {point2i32 {x1 - w, y0 + 0}, sizei32x {w},       rh}
+      , {point2i32 {x0 + w, y0 + 0}, rw - sizei32x {w2}, sizei32y {h}}
+      , {point2i32 {x0 + w, y1 - h}, rw - sizei32x {w2}, sizei32y {h}}
+    };
+
+    for (auto const& rect : rects) {
+        fill_rect_(rect, color);
+    }
+
+    ++stats_.draw_calls;
+}
+
+void software_renderer_impl::note_tile_state_(
+    uint32_t const texture_id
+  , uint32_t const color
+) noexcept {
+    if (texture_id != last_texture_) {
+        last_texture_ = texture_id;
+        ++stats_.state_changes;
+    }
+
+    auto& mod = textures_[texture_id].color_mod;
+    if ((color ^ mod) & 0x00FFFFFFu) {
+        mod = color;
+        ++stats_.state_changes;
+    }
+}
+
+void software_renderer_impl::draw_background() {
+    if (background_ == screen_target) {
+        return;
+    }
+
+    auto const& bg = textures_[background_];
+    auto const  w  = bg.width;
+    auto const  h  = bg.height;
+
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+
+    auto const ww = screen_.width;
+    auto const wh = screen_.height;
+
+    for (int32_t y = 0; y < wh; y += h) {
+        for (int32_t x = 0; x < ww; x += w) {
+            draw_tile_(bg, 0, 0, w, h, x, y, 0xFFFFFFFFu);
+        }
+    }
+
+    ++stats_.draw_calls;
+}
+
+} //namespace boken
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "render.hpp"
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace boken {
+
+//=====--------------------------------------------------------------------=====
+// A renderer2d which rasterizes on the CPU into an in-memory framebuffer
+// rather than to a window; for running the renderers without a display, as in
+// tests and benchmarks.
+//
+// Colors, both of textures and of the framebuffer, are 0xAABBGGRR; i.e. RGBA
+// in memory on a little-endian machine, and the same as the colors passed to
+// the drawing functions. Blending and color modulation follow the same rules
+// as the SDL renderer (SDL_BLENDMODE_BLEND):
+//   src.rgb = src.rgb * mod.rgb
+//   dst.rgb = src.rgb * src.a + dst.rgb * (1 - src.a)
+//   dst.a   = src.a           + dst.a   * (1 - src.a)
+// and scaled tiles are sampled from the nearest texel.
+//=====--------------------------------------------------------------------=====
+class software_renderer : public renderer2d {
+public:
+    virtual ~software_renderer();
+
+    //! Add a texture of @p w x @p h pixels given row by row.
+    //! @returns The id of the texture for use with draw_tiles.
+    virtual uint32_t add_texture(sizei32x w, sizei32y h
+                               , std::vector<uint32_t> pixels) = 0;
+
+    //! Set the texture tiled across the window by draw_background.
+    virtual void set_background(uint32_t texture_id) noexcept = 0;
+
+    //! Discard the contents of the framebuffer and change its size.
+    virtual void resize(sizei32x w, sizei32y h) = 0;
+
+    //! Whether has_targets reports that targets are supported; true by
+    //! default. This allows both paths of a renderer to be exercised.
+    //! @returns The previous state.
+    virtual bool enable_targets(bool enabled) noexcept = 0;
+
+    //! The framebuffer; row by row, get_client_rect().width() pixels per row.
+    virtual std::vector<uint32_t> const& pixels() const noexcept = 0;
+};
+
+std::unique_ptr<software_renderer> make_software_renderer(sizei32x w, sizei32y h);
+
+} //namespace boken
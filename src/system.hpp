@@ -3,6 +3,7 @@
 #include "math_types.hpp"
 #include "system_input.hpp"
 
+#include <chrono>
 #include <memory>
 #include <functional>
 
@@ -33,6 +34,11 @@ public:
     virtual bool is_running() = 0;
     virtual int32_t do_events() = 0;
 
+    //! Block until there is an event, or until @p timeout has passed, then
+    //! handle every event pending as do_events does.
+    //! @returns The number of events handled.
+    virtual int32_t wait_events(std::chrono::milliseconds timeout) = 0;
+
     virtual recti32 get_client_rect() const = 0;
 };
 
@@ -9,11 +9,21 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
 
+// SDL_RenderGeometry is new in 2.0.18; older versions draw tiles one at a time.
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#   define BK_SDL_HAS_RENDER_GEOMETRY 1
+#else
+#   define BK_SDL_HAS_RENDER_GEOMETRY 0
+#endif
+
+#include <algorithm>            // for max
+#include <chrono>
 #include <functional>           // for function
 #include <memory>               // for unique_ptr
 #include <stdexcept>            // for runtime_error
 #include <tuple>                // for tie, tuple
 #include <utility>              // for move, pair, swap
+#include <vector>
 
 #include <cstdint>              // for uint16_t, uint8_t, uint32_t
 
@@ -171,12 +181,20 @@ public:
         }
     }
 
-    void set_color_mod(uint32_t const c) noexcept {
+    //! @returns false if @p c is already the color mod; nothing is done.
+    bool set_color_mod(uint32_t const c) noexcept {
+        if (((c ^ color_mod_) & 0x00FFFFFFu) == 0) {
+            return false;
+        }
+
         SDL_SetTextureColorMod(
             *this
           , static_cast<uint8_t>((c >>  0) & 0xFFu)
           , static_cast<uint8_t>((c >>  8) & 0xFFu)
           , static_cast<uint8_t>((c >> 16) & 0xFFu));
+
+        color_mod_ = c;
+        return true;
     }
 
     operator SDL_Texture*() const noexcept {
@@ -187,6 +205,7 @@ public:
     auto height() const noexcept { return height_; }
 private:
     std::unique_ptr<SDL_Texture, sdl_deleter_texture> handle_;
+    uint32_t color_mod_ {0xFFFFFFFFu}; //!< the SDL default
     int width_  {};
     int height_ {};
 };
@@ -241,6 +260,17 @@ sdl_texture create_texture_from_file(sdl_renderer& render, string_view const fil
     return result;
 }
 
+sdl_texture create_target_texture(sdl_renderer& render, int const w, int const h) {
+    auto result = sdl_texture {SDL_CreateTexture(render
+      , SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h)};
+
+    if (SDL_SetTextureBlendMode(result, SDL_BLENDMODE_BLEND)) {
+        throw sdl_error {SDL_GetError()};
+    }
+
+    return result;
+}
+
 template <typename T>
 constexpr SDL_Rect make_sdl_rect_(axis_aligned_rect<T> const r) noexcept {
     return { value_cast(r.x0)
@@ -386,6 +416,7 @@ public:
     }
 
     int do_events() final override;
+    int wait_events(std::chrono::milliseconds timeout) final override;
 
     recti32 get_client_rect() const final override {
         int w = 0;
@@ -411,62 +442,87 @@ private:
     int window_w_ {};
     int window_h_ {};
 
+    uint32_t target_generation_ {}; //!< see renderer2d::target_generation
+
     bool running_ = true;
+
+    void handle_event_(SDL_Event const& event);
 };
 
 int sdl_system::do_events() {
     int count = 0;
 
     for (SDL_Event event; SDL_PollEvent(&event); ++count) {
-        switch (event.type) {
-        case SDL_WINDOWEVENT :
-            handle_window_event(event.window);
-            break;
-        case SDL_QUIT:
-            running_ = !handler_quit_();
-            break;
-        case SDL_TEXTINPUT :
-            handler_text_input_(text_input_event {
-                event.text.timestamp
-              , event.text.text});
-            break;
-        case SDL_KEYDOWN :
-        case SDL_KEYUP :
-            handler_key_(kb_event {
-                event.key.timestamp
-                , static_cast<kb_scancode>(event.key.keysym.scancode)
-                , static_cast<kb_keycode>(event.key.keysym.sym)
-                , event.key.keysym.mod
-                , !!event.key.repeat
-                , event.key.state == SDL_PRESSED
-            }, kb_modifiers {event.key.keysym.mod});
-            break;
-        case SDL_MOUSEMOTION :
-            handle_event_mouse_move(event.motion);
-            break;
-        case SDL_MOUSEBUTTONDOWN :
-        case SDL_MOUSEBUTTONUP :
-            handle_event_mouse_button(event.button);
-            break;
-        case SDL_MOUSEWHEEL :
-            handler_mouse_wheel_(event.wheel.y, event.wheel.x, get_key_mods());
-            break;
-        default:
-            break;
-        }
+        handle_event_(event);
     }
 
     return count;
 }
 
+int sdl_system::wait_events(std::chrono::milliseconds const timeout) {
+    using rep_t = std::chrono::milliseconds::rep;
+
+    // a negative timeout would wait indefinitely
+    auto const ms = clamp_as<int>(std::max(timeout.count(), rep_t {0}));
+
+    SDL_Event event;
+    if (!SDL_WaitEventTimeout(&event, ms)) {
+        return 0;
+    }
+
+    handle_event_(event);
+    return 1 + do_events();
+}
+
+void sdl_system::handle_event_(SDL_Event const& event) {
+    switch (event.type) {
+    case SDL_WINDOWEVENT :
+        handle_window_event(event.window);
+        break;
+    case SDL_QUIT:
+        running_ = !handler_quit_();
+        break;
+    case SDL_TEXTINPUT :
+        handler_text_input_(text_input_event {
+            event.text.timestamp
+          , event.text.text});
+        break;
+    case SDL_KEYDOWN :
+    case SDL_KEYUP :
+        handler_key_(kb_event {
+            event.key.timestamp
+            , static_cast<kb_scancode>(event.key.keysym.scancode)
+            , static_cast<kb_keycode>(event.key.keysym.sym)
+            , event.key.keysym.mod
+            , !!event.key.repeat
+            , event.key.state == SDL_PRESSED
+        }, kb_modifiers {event.key.keysym.mod});
+        break;
+    case SDL_MOUSEMOTION :
+        handle_event_mouse_move(event.motion);
+        break;
+    case SDL_MOUSEBUTTONDOWN :
+    case SDL_MOUSEBUTTONUP :
+        handle_event_mouse_button(event.button);
+        break;
+    case SDL_MOUSEWHEEL :
+        handler_mouse_wheel_(event.wheel.y, event.wheel.x, get_key_mods());
+        break;
+    case SDL_RENDER_TARGETS_RESET : BK_ATTRIBUTE_FALLTHROUGH;
+    case SDL_RENDER_DEVICE_RESET :
+        ++target_generation_;
+        break;
+    default:
+        break;
+    }
+}
+
 std::unique_ptr<system> make_system() {
     return std::make_unique<sdl_system>();
 }
 
 /////////////////////////////////
 
-renderer2d::~renderer2d() = default;
-
 class sdl_renderer_impl final : public renderer2d {
 public:
     sdl_renderer_impl(system& sys);
@@ -520,6 +576,7 @@ public:
     void render_clear() final override {
         SDL_SetRenderDrawColor(r_, 127, 127, 0, 255);
         SDL_RenderClear(r_);
+        stats_ = stats_t {};
     }
     void render_present() final override {
         SDL_RenderPresent(r_);
@@ -593,13 +650,6 @@ public:
         BK_ASSERT(p.count >= 0
                && p.texture_id < textures_.size());
 
-        auto&               texture    = textures_[p.texture_id];
-        SDL_Texture*  const tex_handle = texture;
-        SDL_Renderer* const renderer   = r_;
-
-        uint32_t last_color = 0;
-        texture.set_color_mod(last_color);
-
         auto const tx = ceil_as<int>(trans_.trans_x / trans_.scale_x);
         auto const ty = ceil_as<int>(trans_.trans_y / trans_.scale_y);
         auto const w  = value_cast(p.tile_w);
@@ -607,68 +657,222 @@ public:
 
         BK_ASSERT(w >= 0 && h >= 0);
 
-        auto p_xy = p.pos_coords;
-        auto p_st = p.tex_coords;
-        auto p_c  = p.colors;
-
-        auto const n = static_cast<size_t>(p.count);
-        for (size_t i = 0; i < n; ++i, ++p_xy, ++p_st, ++p_c) {
-            auto const xy    = p_xy.value<point2i16>();
-            auto const st    = p_st.value<point2i16>();
-            auto const color = p_c.value<uint32_t>();
-
-            if (color != last_color) {
-                texture.set_color_mod(last_color = color);
-            }
+        draw_tiles_impl(textures_[p.texture_id], static_cast<size_t>(p.count), [&] {
+            return [=, p_xy = p.pos_coords, p_st = p.tex_coords, p_c = p.colors]() mutable {
+                auto const xy = p_xy.value<point2i16>();
+                auto const st = p_st.value<point2i16>();
 
-            SDL_Rect src {value_cast(st.x),      value_cast(st.y),      w, h};
-            SDL_Rect dst {value_cast(xy.x) + tx, value_cast(xy.y) + ty, w, h};
+                tile_t const result {
+                    {value_cast(st.x),      value_cast(st.y),      w, h}
+                  , {value_cast(xy.x) + tx, value_cast(xy.y) + ty, w, h}
+                  , p_c.value<uint32_t>()};
 
-            SDL_RenderCopy(renderer, tex_handle, &src, &dst);
-        }
+                ++p_xy; ++p_st; ++p_c;
+                return result;
+            };
+        });
     }
 
     void draw_tiles(tile_params_variable const& p) final override {
         BK_ASSERT(p.count >= 0
                && p.texture_id < textures_.size());
 
-        auto&               texture    = textures_[p.texture_id];
-        SDL_Texture*  const tex_handle = texture;
-        SDL_Renderer* const renderer   = r_;
-
-        uint32_t last_color = 0;
-        texture.set_color_mod(last_color);
-
         auto const tx = ceil_as<int>(trans_.trans_x / trans_.scale_x);
         auto const ty = ceil_as<int>(trans_.trans_y / trans_.scale_y);
 
-        auto p_xy = p.pos_coords;
-        auto p_st = p.tex_coords;
-        auto p_wh = p.tex_sizes;
-        auto p_c  = p.colors;
-
-        auto const n = static_cast<size_t>(p.count);
-        for (size_t i = 0; i < n; ++i, ++p_xy, ++p_st, ++p_wh, ++p_c) {
-            auto const xy    = p_xy.value<point2i16>();
-            auto const st    = p_st.value<point2i16>();
-            auto const wh    = p_wh.value<point2i16>();
-            auto const w     = value_cast(wh.x);
-            auto const h     = value_cast(wh.y);
-            auto const color = p_c.value<uint32_t>();
-
-            if (color != last_color) {
-                texture.set_color_mod(last_color = color);
-            }
+        draw_tiles_impl(textures_[p.texture_id], static_cast<size_t>(p.count), [&] {
+            return [=, p_xy = p.pos_coords, p_st = p.tex_coords
+                     , p_wh = p.tex_sizes,  p_c  = p.colors]() mutable {
+                auto const xy = p_xy.value<point2i16>();
+                auto const st = p_st.value<point2i16>();
+                auto const wh = p_wh.value<point2i16>();
+                auto const w  = value_cast(wh.x);
+                auto const h  = value_cast(wh.y);
+
+                tile_t const result {
+                    {value_cast(st.x),      value_cast(st.y),      w, h}
+                  , {value_cast(xy.x) + tx, value_cast(xy.y) + ty, w, h}
+                  , p_c.value<uint32_t>()};
+
+                ++p_xy; ++p_st; ++p_wh; ++p_c;
+                return result;
+            };
+        });
+    }
+
+    bool has_targets() const noexcept final override {
+        return SDL_RenderTargetSupported(r_) == SDL_TRUE;
+    }
+
+    uint32_t create_target(sizei32x const w, sizei32y const h) final override {
+        BK_ASSERT(has_targets());
+
+        textures_.push_back(create_target_texture(r_, value_cast(w), value_cast(h)));
+        return static_cast<uint32_t>(textures_.size() - 1u);
+    }
+
+    void set_target(uint32_t const id) final override {
+        auto const to_screen = (id == screen_target);
+        BK_ASSERT(to_screen || id < textures_.size());
+
+        if (to_screen && !on_target_) {
+            return;
+        }
+
+        if (!on_target_) {
+            screen_trans_ = trans_;
+            screen_clip_  = clip_rect_;
+        }
+
+        SDL_Texture* const target = to_screen
+          ? nullptr : static_cast<SDL_Texture*>(textures_[id]);
+        if (SDL_SetRenderTarget(r_, target)) {
+            throw sdl_error {SDL_GetError()};
+        }
 
-            SDL_Rect src {value_cast(st.x),      value_cast(st.y),      w, h};
-            SDL_Rect dst {value_cast(xy.x) + tx, value_cast(xy.y) + ty, w, h};
+        on_target_ = !to_screen;
 
-            SDL_RenderCopy(renderer, tex_handle, &src, &dst);
+        if (to_screen) {
+            set_transform(screen_trans_);
+            set_clip_rect(screen_clip_);
+            clip_rect_ = screen_clip_;
+            return;
         }
+
+        transform();
+        clip_rect();
+
+        SDL_SetRenderDrawColor(r_, 0, 0, 0, 0);
+        SDL_RenderClear(r_);
+    }
+
+    uint32_t target_generation() const noexcept final override {
+        return sys_.target_generation_;
+    }
+
+    bool allows_any_thread() const noexcept final override {
+        return false; // SDL requires rendering on the thread of the window
+    }
+
+    stats_t stats() const noexcept final override {
+        return stats_;
+    }
+
+    bool set_batching(bool const enabled) noexcept final override {
+        return batching_ = enabled && (BK_SDL_HAS_RENDER_GEOMETRY != 0);
     }
 
 //------------------------------------------------------------------------------
 
+    struct tile_t {
+        SDL_Rect src;
+        SDL_Rect dst;
+        uint32_t color;
+    };
+
+    //! @param tiles A function returning a function which returns the next
+    //!        tile_t each time it is invoked; i.e. a new cursor over the tiles.
+    template <typename Tiles>
+    void draw_tiles_impl(sdl_texture& texture, size_t const n, Tiles tiles) {
+        stats_.tiles += static_cast<uint32_t>(n);
+
+        SDL_Texture* const tex_handle = texture;
+        if (n && tex_handle != last_texture_) {
+            last_texture_ = tex_handle;
+            ++stats_.state_changes;
+        }
+
+#if BK_SDL_HAS_RENDER_GEOMETRY
+        if (batching_ && draw_tiles_batched_(texture, n, tiles())) {
+            return;
+        }
+#endif
+
+        SDL_Renderer* const renderer = r_;
+
+        auto next = tiles();
+        for (size_t i = 0; i < n; ++i) {
+            auto const t = next();
+
+            if (texture.set_color_mod(t.color)) {
+                ++stats_.state_changes;
+            }
+
+            SDL_RenderCopy(renderer, tex_handle, &t.src, &t.dst);
+        }
+
+        stats_.draw_calls += static_cast<uint32_t>(n);
+    }
+
+#if BK_SDL_HAS_RENDER_GEOMETRY
+    //! Submit every tile as a pair of triangles in a single call; the color of
+    //! each tile is applied through its vertices rather than by changing the
+    //! color mod of the texture.
+    //! @returns false, and disables batching, if the renderer can't draw
+    //!          geometry; nothing has been drawn.
+    template <typename NextTile>
+    bool draw_tiles_batched_(sdl_texture& texture, size_t const n, NextTile next) {
+        if (n == 0) {
+            return true;
+        }
+
+        // the color mod would otherwise modulate the colors of the vertices
+        if (texture.set_color_mod(0xFFFFFFFFu)) {
+            ++stats_.state_changes;
+        }
+
+        auto const sw = 1.0f / static_cast<float>(texture.width());
+        auto const sh = 1.0f / static_cast<float>(texture.height());
+
+        vertices_.clear();
+        vertices_.reserve(n * 4u);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto const t = next();
+
+            auto const x0 = static_cast<float>(t.dst.x);
+            auto const y0 = static_cast<float>(t.dst.y);
+            auto const x1 = static_cast<float>(t.dst.x + t.dst.w);
+            auto const y1 = static_cast<float>(t.dst.y + t.dst.h);
+
+            auto const s0 = static_cast<float>(t.src.x)           * sw;
+            auto const t0 = static_cast<float>(t.src.y)           * sh;
+            auto const s1 = static_cast<float>(t.src.x + t.src.w) * sw;
+            auto const t1 = static_cast<float>(t.src.y + t.src.h) * sh;
+
+            SDL_Color const c {
+                static_cast<uint8_t>((t.color >>  0) & 0xFFu)
+              , static_cast<uint8_t>((t.color >>  8) & 0xFFu)
+              , static_cast<uint8_t>((t.color >> 16) & 0xFFu)
+              , 0xFFu};
+
+            vertices_.push_back({{x0, y0}, c, {s0, t0}});
+            vertices_.push_back({{x1, y0}, c, {s1, t0}});
+            vertices_.push_back({{x0, y1}, c, {s0, t1}});
+            vertices_.push_back({{x1, y1}, c, {s1, t1}});
+        }
+
+        // the indices are the same for every batch of the same size or less
+        for (auto i = indices_.size() / 6u; i < n; ++i) {
+            auto const v = static_cast<int>(i * 4u);
+            indices_.insert(end(indices_), {v + 0, v + 1, v + 2
+                                          , v + 2, v + 1, v + 3});
+        }
+
+        auto const result = SDL_RenderGeometry(r_, texture
+          , vertices_.data(), static_cast<int>(n * 4u)
+          , indices_.data(),  static_cast<int>(n * 6u));
+
+        if (result) {
+            batching_ = false;
+            return false;
+        }
+
+        ++stats_.draw_calls;
+        return true;
+    }
+#endif
+
     template <typename FwdIt, typename SetColor>
     void fill_rects_impl(FwdIt const first, FwdIt const last, SetColor c) {
         for (auto it = first; it != last; ++it) {
@@ -676,6 +880,7 @@ public:
 
             auto const r = make_sdl_rect_(*it);
             SDL_RenderFillRect(r_, &r);
+            ++stats_.draw_calls;
         }
     }
 
@@ -709,6 +914,7 @@ public:
 
             c();
             SDL_RenderFillRects(r_, rects, count);
+            ++stats_.draw_calls;
         }
     }
 
@@ -720,6 +926,22 @@ private:
 
     transform_t trans_ {1.0f, 1.0f, 0.0f, 0.0f};
     recti32     clip_rect_;
+
+    stats_t stats_    {};
+    bool    batching_ {BK_SDL_HAS_RENDER_GEOMETRY != 0};
+
+    //! the texture of the last tiles drawn; to count changes of it
+    SDL_Texture const* last_texture_ {};
+
+    // the state of the window while drawing to a target; see set_target
+    transform_t screen_trans_ {1.0f, 1.0f, 0.0f, 0.0f};
+    recti32     screen_clip_;
+    bool        on_target_ {false};
+
+#if BK_SDL_HAS_RENDER_GEOMETRY
+    std::vector<SDL_Vertex> vertices_; //!< reused by draw_tiles_batched_
+    std::vector<int>        indices_;  //!< grown as needed; never cleared
+#endif
 };
 
 std::unique_ptr<renderer2d> make_renderer(system& sys) {
@@ -770,6 +992,8 @@ void sdl_renderer_impl::draw_background() {
             SDL_RenderCopy(r_, bg, nullptr, &r);
         }
     }
+
+    stats_.draw_calls += static_cast<uint32_t>(tx * ty);
 }
 
 } //namespace boken
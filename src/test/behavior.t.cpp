@@ -0,0 +1,110 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "behavior.hpp"
+
+#include "data.hpp"
+#include "entity_def.hpp"
+#include "hash.hpp"
+#include "random.hpp"
+
+#include <string>
+#include <vector>
+
+TEST_CASE("behavior compile") {
+    using namespace boken;
+
+    behavior_program p;
+    std::string      error;
+
+    SECTION("well formed") {
+        REQUIRE(compile_behavior({
+            "player_within 2 & chance 50 -> flee_player"
+          , "other_within 5 -> approach_other 10"
+          , "-> wander 10"
+        }, p, error));
+
+        REQUIRE(error.empty());
+        REQUIRE(p.size() == 3 + 2 + 1);
+        REQUIRE(p.uses_player());
+        REQUIRE(p.sense_radius() == 5);
+    }
+
+    SECTION("an unconditional wait is implied") {
+        REQUIRE(compile_behavior({"chance 10 -> wander"}, p, error));
+        REQUIRE(p.size() == 3);
+        REQUIRE(!p.uses_player());
+        REQUIRE(p.sense_radius() == 0);
+    }
+
+    SECTION("malformed") {
+        for (auto const& rule : {
+            "player_within -> wait"
+          , "player_within 2 wait"
+          , "player_within 2 chance 3 -> wait"
+          , "nonsense 2 -> wait"
+          , "-> nonsense"
+          , "-> wait 0"
+          , "-> wait 1 2"
+          , "chance 10 & -> wait"
+        }) {
+            error.clear();
+            REQUIRE(!compile_behavior({rule}, p, error));
+            REQUIRE(!error.empty());
+            REQUIRE(p.size() == 0);
+        }
+
+        REQUIRE(!compile_behavior({"-> wait", "-> wander"}, p, error));
+    }
+}
+
+TEST_CASE("behavior run") {
+    using namespace boken;
+
+    auto const rng = make_random_state();
+
+    behavior_program p;
+    std::string      error;
+
+    REQUIRE(compile_behavior({
+        "player_within 1 -> wait"
+      , "player_within 8 & other_beyond 3 -> approach_player 2"
+      , "other_within 3 -> approach_other"
+      , "chance 0 -> flee_player"
+      , "-> wander 5"
+    }, p, error));
+
+    auto const run = [&](int32_t const player, int32_t const other) {
+        behavior_inputs in;
+        in.player_distance = player;
+        in.other_distance  = other;
+        return p.run(in, *rng);
+    };
+
+    auto const none = behavior_inputs::none;
+
+    REQUIRE(run(1, none).action    == behavior_action::wait);
+    REQUIRE(run(5, none).action    == behavior_action::approach_player);
+    REQUIRE(run(5, none).turns     == 2);
+    REQUIRE(run(5, 2).action       == behavior_action::approach_other);
+    REQUIRE(run(none, 3).action    == behavior_action::approach_other);
+    REQUIRE(run(none, none).action == behavior_action::wander);
+    REQUIRE(run(none, none).turns  == 5);
+}
+
+TEST_CASE("behavior definitions") {
+    using namespace boken;
+
+    auto const db = make_game_database();
+
+    auto const def = db->find(make_id<entity_id>("rat_small"));
+    REQUIRE(!!def);
+    REQUIRE(def->behavior == db->find(make_id<behavior_id>("passive")));
+    REQUIRE(def->behavior != nullptr);
+
+    // no ai_type
+    auto const player = db->find(make_id<entity_id>("player"));
+    REQUIRE(!!player);
+    REQUIRE(player->behavior == db->find(make_id<behavior_id>("default")));
+}
+
+#endif // !defined(BK_NO_TESTS)
@@ -0,0 +1,105 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "diffusion.hpp"
+
+namespace {
+
+boken::diffusion_field make_open_mask(boken::sizei32x const w, boken::sizei32y const h) {
+    using namespace boken;
+
+    diffusion_field result {w, h};
+    for (auto y = 0; y < value_cast(h); ++y) {
+        for (auto x = 0; x < value_cast(w); ++x) {
+            result.set(point2i32 {x, y}, 1.0f);
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("diffusion_field") {
+    using namespace boken;
+
+    auto const w = sizei32x {11};
+    auto const h = sizei32y {11};
+
+    diffusion_field f {w, h};
+    auto mask = make_open_mask(w, h);
+
+    // in the middle so the boundary doesn't skew the field
+    auto const source = point2i32 {5, 5};
+    f.add(source, 100.0f);
+
+    REQUIRE(f.at(source) == Approx(100.0f));
+    REQUIRE(f.at(point2i32 {-1, 0}) == Approx(0.0f));
+    REQUIRE(f.at(point2i32 {11, 0}) == Approx(0.0f));
+
+    SECTION("without decay the total is preserved") {
+        for (int i = 0; i < 50; ++i) {
+            f.update(mask, 0.25f, 1.0f);
+        }
+
+        REQUIRE(f.total() == Approx(100.0f));
+        REQUIRE(f.at(point2i32 {10, 10}) > 0.0f);
+        REQUIRE(f.at(source) < 100.0f);
+    }
+
+    SECTION("the field spreads the same way in every direction") {
+        // the rows are processed 4 tiles at a time where possible, with the
+        // rest done one by one; both must give the same result.
+        for (int i = 0; i < 10; ++i) {
+            f.update(mask, 0.2f, 1.0f);
+        }
+
+        for (auto d = 1; d <= 5; ++d) {
+            auto const v = f.at(source + vec2i32 {d, 0});
+            REQUIRE(v > 0.0f);
+            REQUIRE(f.at(source - vec2i32 {d, 0}) == Approx(v));
+            REQUIRE(f.at(source + vec2i32 {0, d}) == Approx(v));
+            REQUIRE(f.at(source - vec2i32 {0, d}) == Approx(v));
+        }
+    }
+
+    SECTION("decay") {
+        f.update(mask, 0.25f, 0.5f);
+        REQUIRE(f.total() == Approx(50.0f));
+    }
+
+    SECTION("solid tiles block the field") {
+        for (auto y = 0; y < 11; ++y) {
+            mask.set(point2i32 {7, y}, 0.0f);
+        }
+
+        for (int i = 0; i < 100; ++i) {
+            f.update(mask, 0.25f, 1.0f);
+        }
+
+        REQUIRE(f.total() == Approx(100.0f));
+
+        for (auto y = 0; y < 11; ++y) {
+            for (auto x = 7; x < 11; ++x) {
+                REQUIRE(f.at(point2i32 {x, y}) == Approx(0.0f));
+            }
+        }
+    }
+
+    SECTION("the gradient leads to the source") {
+        for (int i = 0; i < 30; ++i) {
+            f.update(mask, 0.2f, 0.9f);
+        }
+
+        auto p = point2i32 {10, 1};
+        for (int i = 0; i < 10 && p != source; ++i) {
+            auto const v = f.gradient(p);
+            REQUIRE(v != vec2i32 {});
+            p += v;
+        }
+
+        REQUIRE(p == source);
+        REQUIRE(f.gradient(source) == vec2i32 {});
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
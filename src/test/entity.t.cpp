@@ -2,6 +2,11 @@
 #include "catch.hpp"
 #include "entity.hpp"
 #include "entity_def.hpp"
+#include "item.hpp"
+#include "data.hpp"
+#include "world.hpp"
+#include "random.hpp"
+#include "hash.hpp"
 
 #include <algorithm>
 #include <array>
@@ -79,4 +84,126 @@ TEST_CASE("property_set") {
 }
 
 
+TEST_CASE("property_slots") {
+    using namespace boken;
+
+    entity_definition def {"test", entity_id {1u}};
+
+    def.properties.add_or_update_properties({
+        {entity_property_id {djb2_hash_32c("tile_index")}, 5u}
+      , {entity_property_id {djb2_hash_32c("can_equip")},  1u}
+      , {entity_property_id {djb2_hash_32c("not_slotted")}, 7u}
+    });
+
+    // slots are only valid once updated
+    REQUIRE(!def.slots.has(static_cast<size_t>(property_slot::tile_index)));
+    def.update_slots();
+
+    REQUIRE(def.slots.value_or(property_slot::tile_index, 0u) == 5u);
+    REQUIRE(def.slots.value_or(property_slot::can_equip,  0u) == 1u);
+    REQUIRE(def.slots.value_or(property_slot::ai_type,    9u) == 9u);
+
+    REQUIRE(property_slot_of(djb2_hash_32c("not_slotted")) == property_slot_count);
+
+    for (size_t i = 0; i < property_slot_count; ++i) {
+        auto const slot = static_cast<property_slot>(i);
+        REQUIRE(property_slot_of(property_slot_id(slot)) == i);
+    }
+
+    SECTION("instance overrides") {
+        auto const db  = make_game_database();
+        auto const w   = make_world();
+        auto const rng = make_random_state();
+
+        entity e {w->get_item_deleter(), *db, def, entity_instance_id {}, *rng};
+
+        auto const tile_index = entity_property_id {djb2_hash_32c("tile_index")};
+        REQUIRE(e.property_value_or(def, tile_index, 0u) == 5u);
+
+        e.add_or_update_property(tile_index, 8u);
+        REQUIRE(e.property_value_or(def, tile_index, 0u) == 8u);
+
+        e.add_or_update_property(tile_index, 9u);
+        REQUIRE(e.property_value_or(def, tile_index, 0u) == 9u);
+
+        // the definition's value is seen again once the override is removed
+        REQUIRE(e.remove_property(tile_index));
+        REQUIRE(e.property_value_or(def, tile_index, 0u) == 5u);
+    }
+}
+
+TEST_CASE("entity body plan") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    auto const player_def = db->find(make_id<entity_id>("player"));
+    auto const rat_def    = db->find(make_id<entity_id>("rat_small"));
+    auto const dagger_def = db->find(make_id<item_id>("weapon_dagger"));
+
+    REQUIRE((player_def && rat_def && dagger_def));
+    REQUIRE(!!player_def->body);
+    REQUIRE(!rat_def->body);
+
+    auto const& plan = *player_def->body;
+    REQUIRE(plan.parts.size() == 9);
+    REQUIRE(plan.parts[0] == make_id<body_part_id>("head"));
+
+    auto const e0 = create_object(*db, *w, *player_def, *rng);
+    auto const e1 = create_object(*db, *w, *player_def, *rng);
+    auto const e2 = create_object(*db, *w, *rat_def,    *rng);
+
+    auto& player = w->find(e0.get());
+
+    // parts ids come from the shared plan
+    REQUIRE(std::distance(player.body_begin(), player.body_end()) == 9);
+    REQUIRE(std::equal(player.body_begin(), player.body_end(), plan.parts.begin()
+      , [](body_part const& p, body_part_id const id) {
+            return p.id == id && p.is_free(); }));
+
+    REQUIRE(w->find(e2.get()).body_begin() == w->find(e2.get()).body_end());
+
+    auto dagger = create_object(*db, *w, *dagger_def, *rng);
+    auto const dagger_id = dagger.get();
+    player.add_item(std::move(dagger));
+
+    auto const hand = make_id<body_part_id>("hand_right");
+    player.equip(hand, dagger_id);
+
+    REQUIRE(player.items().empty());
+    REQUIRE(std::count_if(player.body_begin(), player.body_end()
+      , [&](body_part const& p) { return p.id == hand && p.equip == dagger_id; }) == 1);
+
+    // other instances are unaffected
+    auto const& other = w->find(e1.get());
+    REQUIRE(std::all_of(other.body_begin(), other.body_end()
+      , [](body_part const& p) { return p.is_free(); }));
+
+    player.unequip(dagger_id);
+    REQUIRE(player.items().size() == 1);
+    REQUIRE(std::all_of(player.body_begin(), player.body_end()
+      , [](body_part const& p) { return p.is_free(); }));
+
+    SECTION("move assignment") {
+        auto const& deleter = w->get_item_deleter();
+
+        entity a {deleter, *db, *player_def, entity_instance_id {}, *rng};
+        entity b {deleter, *db, *rat_def,    entity_instance_id {}, *rng};
+
+        auto sword = create_object(*db, *w, *dagger_def, *rng);
+        auto const sword_id = sword.get();
+        a.add_item(std::move(sword));
+        a.equip(hand, sword_id);
+
+        a = std::move(b);
+        REQUIRE(a.body_begin() == a.body_end());
+
+        // the moved-from entity keeps the plan for the equipment it now owns
+        REQUIRE(std::count_if(b.body_begin(), b.body_end()
+          , [&](body_part const& p) { return p.equip == sword_id; }) == 1);
+    }
+}
+
 #endif // !defined(BK_NO_TESTS)
@@ -0,0 +1,98 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "flat_table.hpp"
+
+#include "data.hpp"
+#include "item_def.hpp"
+#include "hash.hpp"
+#include "math_types.hpp"
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+TEST_CASE("flat_table") {
+    using namespace boken;
+
+    flat_table<item_id, std::string> table;
+
+    table.insert(item_id {30u}, "c");
+    table.insert(item_id {10u}, "a");
+    table.insert(item_id {20u}, "b");
+    table.insert(item_id {10u}, "d");
+
+    REQUIRE(table.size() == 4);
+
+    std::vector<std::pair<std::string, std::string>> duplicates;
+    auto const collisions = table.freeze(
+        [&](std::string const& kept, std::string const& dup) {
+            duplicates.push_back({kept, dup});
+            return false;
+        });
+
+    REQUIRE(table.frozen());
+    REQUIRE(collisions == 1);
+    REQUIRE(table.size() == 3);
+
+    // the value staged first is kept
+    REQUIRE(duplicates.size() == 1);
+    REQUIRE(duplicates[0].first  == "a");
+    REQUIRE(duplicates[0].second == "d");
+
+    REQUIRE(table.find(item_id {10u}));
+    REQUIRE(*table.find(item_id {10u}) == "a");
+    REQUIRE(*table.find(item_id {20u}) == "b");
+    REQUIRE(*table.find(item_id {30u}) == "c");
+
+    REQUIRE(!table.find(item_id {0u}));
+    REQUIRE(!table.find(item_id {15u}));
+    REQUIRE(!table.find(item_id {40u}));
+}
+
+TEST_CASE("flat_table merge") {
+    using namespace boken;
+
+    flat_table<item_property_id, int> table;
+
+    table.insert(item_property_id {2u}, 1);
+    table.insert(item_property_id {1u}, 1);
+    table.insert(item_property_id {2u}, 1);
+    table.insert(item_property_id {2u}, 1);
+
+    auto const collisions = table.freeze([](int& kept, int const dup) {
+        kept += dup;
+        return true;
+    });
+
+    REQUIRE(collisions == 0);
+    REQUIRE(table.size() == 2);
+    REQUIRE(*table.find(item_property_id {1u}) == 1);
+    REQUIRE(*table.find(item_property_id {2u}) == 3);
+}
+
+TEST_CASE("flat_table lookup") {
+    using namespace boken;
+
+    flat_table<item_id, uint32_t> table;
+
+    constexpr uint32_t n = 1000;
+    for (uint32_t i = 0; i < n; ++i) {
+        auto const s = std::to_string(i);
+        table.insert(make_id<item_id>(string_view {s.data(), s.size()}), i);
+    }
+
+    REQUIRE(table.freeze() == 0);
+    REQUIRE(table.size() == n);
+    REQUIRE(table.is_perfectly_hashed());
+
+    for (uint32_t i = 0; i < n; ++i) {
+        auto const s = std::to_string(i);
+        auto const v = table.find(make_id<item_id>(string_view {s.data(), s.size()}));
+        REQUIRE(v);
+        REQUIRE(*v == i);
+    }
+
+    REQUIRE(!table.find(make_id<item_id>("not present")));
+}
+
+#endif // !defined(BK_NO_TESTS)
@@ -1,11 +1,14 @@
 #if !defined(BK_NO_TESTS)
 #include "catch.hpp"
 #include "graph.hpp"
+#include "graph.t.hpp"
 
 #include "math_types.hpp"
 #include "math.hpp"
+
 #include <queue>
 #include <array>
+#include <vector>
 
 namespace boken {
 
@@ -67,7 +70,6 @@ private:
     int32_t width_;
     int32_t height_;
 };
-
 } // namespace boken
 
 TEST_CASE("a_star_pather") {
@@ -92,6 +94,83 @@ TEST_CASE("a_star_pather") {
     REQUIRE(path.back() == goal);
 }
 
+TEST_CASE("d_star_lite_pather") {
+    using namespace boken;
+
+    mask_graph graph {20, 20};
+
+    // a wall along x = 10 with a gap at the bottom
+    for (auto y = 0; y < 19; ++y) {
+        graph.set_blocked({10, y}, true);
+    }
+
+    auto pather = make_d_star_lite_pather(graph, diagonal_heuristic());
+
+    auto const start = point2i32 {0, 0};
+    auto const goal  = point2i32 {19, 0};
+
+    std::vector<point2i32> path;
+    auto const get_path = [&] {
+        path.clear();
+        pather.copy_path(graph, back_inserter(path));
+        return path;
+    };
+
+    REQUIRE(pather.plan(graph, start, goal));
+    get_path();
+
+    REQUIRE(path.front() == start);
+    REQUIRE(path.back()  == goal);
+    REQUIRE(is_valid_path(graph, path));
+    REQUIRE(path.size() == a_star_path(graph, start, goal).size());
+
+    auto const initial_expanded = pather.expanded();
+
+    SECTION("repair after moving and a new obstacle") {
+        // walk part of the way, then block the next step
+        auto const p = path[5];
+        pather.move_to(p);
+        graph.set_blocked(path[6], true);
+        pather.update(graph, path[6]);
+
+        REQUIRE(pather.replan(graph));
+        get_path();
+
+        REQUIRE(path.front() == p);
+        REQUIRE(path.back()  == goal);
+        REQUIRE(is_valid_path(graph, path));
+        REQUIRE(path.size() == a_star_path(graph, p, goal).size());
+        REQUIRE(pather.expanded() < initial_expanded);
+    }
+
+    SECTION("no path, then a new opening") {
+        graph.set_blocked({10, 19}, true);
+        pather.update(graph, {10, 19});
+        REQUIRE(!pather.replan(graph));
+        REQUIRE(get_path().empty());
+
+        graph.set_blocked({10, 0}, false);
+        pather.update(graph, {10, 0});
+        REQUIRE(pather.replan(graph));
+        get_path();
+
+        REQUIRE(is_valid_path(graph, path));
+        REQUIRE(path.size() == 20u);
+    }
+
+    SECTION("an opening the search isn't told of is only found by a new plan") {
+        graph.set_blocked({10, 19}, true);
+        pather.update(graph, {10, 19});
+        REQUIRE(!pather.replan(graph));
+
+        graph.set_blocked({10, 0}, false);
+        REQUIRE(!pather.replan(graph));
+
+        REQUIRE(pather.plan(graph, start, goal));
+        REQUIRE(get_path().size() == 20u);
+    }
+}
+
 TEST_CASE("graph connected_components 1") {
     using namespace boken;
 
@@ -0,0 +1,106 @@
+#pragma once
+
+//
+// Graphs and path checks shared by the graph tests and benchmarks.
+//
+
+#include "graph.hpp"
+
+#include "math_types.hpp"
+#include "math.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace boken {
+
+//! A grid where any tile can be blocked.
+class mask_graph {
+public:
+    using point = point2i32;
+
+    mask_graph(int32_t const width, int32_t const height)
+      : width_   {width}
+      , height_  {height}
+      , blocked_ (static_cast<size_t>(width * height), 0)
+    {
+    }
+
+    void set_blocked(point const p, bool const blocked) noexcept {
+        blocked_[index_of_(p)] = blocked ? 1 : 0;
+    }
+
+    bool is_passable(point const p) const noexcept {
+        return !blocked_[index_of_(p)];
+    }
+
+    bool is_in_bounds(point const p) const noexcept {
+        auto const x = value_cast(p.x);
+        auto const y = value_cast(p.y);
+
+        return (x >= 0 && x < width_)
+            && (y >= 0 && y < height_);
+    }
+
+    int32_t cost(point, point) const noexcept {
+        return 1;
+    }
+
+    template <typename Predicate, typename UnaryF>
+    void for_each_neighbor_if(point const p, Predicate pred, UnaryF f) const noexcept {
+        for_each_neighbor8_if(*this, p, pred, f);
+    }
+
+    int32_t width()  const noexcept { return width_; }
+    int32_t height() const noexcept { return height_; }
+    int32_t size()   const noexcept { return width_ * height_; }
+private:
+    size_t index_of_(point const p) const noexcept {
+        return static_cast<size_t>(value_cast(p.x) + value_cast(p.y) * width_);
+    }
+
+    int32_t width_;
+    int32_t height_;
+    std::vector<uint8_t> blocked_;
+};
+
+} // namespace boken
+
+namespace {
+
+template <typename Graph>
+std::vector<boken::point2i32> a_star_path(
+    Graph const& graph
+  , boken::point2i32 const start
+  , boken::point2i32 const goal
+) {
+    using namespace boken;
+
+    auto pather = make_a_star_pather(graph);
+
+    std::vector<point2i32> path;
+    if (pather.search(graph, start, goal, diagonal_heuristic()) == goal) {
+        pather.reverse_copy_path(start, goal, back_inserter(path));
+        std::reverse(begin(path), end(path));
+    }
+
+    return path;
+}
+
+//! Each step of the path is to a passable neighbor.
+template <typename Graph>
+bool is_valid_path(Graph const& graph, std::vector<boken::point2i32> const& path) {
+    using namespace boken;
+
+    for (size_t i = 1; i < path.size(); ++i) {
+        auto const v = abs(path[i] - path[i - 1]);
+        if (value_cast(v.x) > 1 || value_cast(v.y) > 1 || v == vec2i32 {}
+         || !graph.is_passable(path[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
@@ -0,0 +1,118 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "item.hpp"
+#include "item_pile.hpp"
+
+#include "data.hpp"
+#include "world.hpp"
+#include "item_properties.hpp"
+#include "random.hpp"
+#include "context.hpp"
+#include "hash.hpp"
+
+#include <vector>
+
+namespace {
+
+struct item_test_state {
+    std::unique_ptr<boken::game_database> db  = boken::make_game_database();
+    std::unique_ptr<boken::world>         w   = boken::make_world();
+    std::unique_ptr<boken::random_state>  rng = boken::make_random_state();
+
+    boken::context ctx {*w, *db};
+
+    boken::item_definition const& def(char const* const id) const {
+        auto const result = db->find(boken::make_id<boken::item_id>(boken::string_view {id}));
+        REQUIRE(!!result);
+        return *result;
+    }
+
+    void merge(boken::item_definition const& d, boken::item_pile& pile) {
+        auto itm = boken::create_object(*db, *w, d, *rng);
+        auto const i = boken::item_descriptor {ctx, itm.get()};
+        boken::merge_into_pile(ctx, std::move(itm), i, pile);
+    }
+
+    std::vector<uint32_t> stack_sizes(boken::item_pile const& pile) const {
+        std::vector<uint32_t> result;
+        for (auto const id : pile) {
+            result.push_back(current_stack_size(
+                boken::const_item_descriptor {boken::const_context {ctx}, id}));
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+TEST_CASE("merge_into_pile") {
+    using namespace boken;
+
+    item_test_state state;
+
+    auto const& potion = state.def("potion_health_small"); // stacks of 5
+    auto const& dagger = state.def("weapon_dagger");       // doesn't stack
+
+    item_pile pile {state.w->get_item_deleter()};
+
+    for (int i = 0; i < 12; ++i) {
+        state.merge(potion, pile);
+    }
+
+    state.merge(dagger, pile);
+
+    REQUIRE(pile.has_stack_index());
+    REQUIRE(state.stack_sizes(pile) == (std::vector<uint32_t> {5, 5, 2, 1}));
+
+    SECTION("removing a partial stack") {
+        auto const id = pile[2];
+        REQUIRE(pile.find_open_stack(potion.id) == id);
+
+        auto itm = pile.remove_item(id);
+        REQUIRE(pile.find_open_stack(potion.id) == item_instance_id {});
+
+        state.merge(potion, pile);
+        REQUIRE(state.stack_sizes(pile) == (std::vector<uint32_t> {5, 5, 1, 1}));
+    }
+
+    SECTION("adding items without stack information") {
+        auto const id = pile[2];
+        auto itm = pile.remove_item(id);
+
+        // the index is stale after this and must be rebuilt
+        pile.add_item(std::move(itm));
+        REQUIRE(!pile.has_stack_index());
+
+        state.merge(potion, pile);
+        REQUIRE(pile.has_stack_index());
+        REQUIRE(state.stack_sizes(pile) == (std::vector<uint32_t> {5, 5, 1, 3}));
+    }
+
+    SECTION("rebuilding the index for another definition") {
+        auto const& coin = state.def("coin");
+
+        auto const id = pile[2];
+        pile.add_item(pile.remove_item(id));
+        REQUIRE(!pile.has_stack_index());
+
+        // the rebuild also finds the partial stack of potions
+        state.merge(coin, pile);
+        REQUIRE(pile.find_open_stack(potion.id) == id);
+
+        state.merge(potion, pile);
+        REQUIRE(state.stack_sizes(pile) == (std::vector<uint32_t> {5, 5, 1, 3, 1}));
+    }
+
+    SECTION("remove_if") {
+        pile.remove_if([](unique_item&& itm, int const i) {
+            if (i == 2) {
+                unique_item {std::move(itm)};
+            }
+        });
+
+        REQUIRE(pile.size() == 3);
+        REQUIRE(pile.find_open_stack(potion.id) == item_instance_id {});
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
@@ -0,0 +1,158 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST_CASE("job_system run and wait") {
+    using namespace boken;
+
+    auto const jobs = make_job_system(4);
+    REQUIRE(jobs->worker_count() == 4);
+
+    constexpr int n = 10000;
+
+    std::atomic<int> count {0};
+    task_group group;
+
+    for (int i = 0; i < n; ++i) {
+        jobs->run(group, [&] { count.fetch_add(1); });
+    }
+
+    jobs->wait(group);
+
+    REQUIRE(group.done());
+    REQUIRE(count.load() == n);
+    REQUIRE(jobs->stats().executed == n);
+}
+
+TEST_CASE("job_system contention") {
+    using namespace boken;
+
+    auto const jobs = make_job_system(4);
+
+    // several threads not owned by the system submitting and waiting at once,
+    // with each job itself spawning and waiting on nested jobs.
+    constexpr int threads = 4;
+    constexpr int outer   = 200;
+    constexpr int inner   = 16;
+
+    std::atomic<int> count {0};
+
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < threads; ++t) {
+        submitters.emplace_back([&] {
+            task_group group;
+            for (int i = 0; i < outer; ++i) {
+                jobs->run(group, [&] {
+                    task_group nested;
+                    for (int j = 0; j < inner; ++j) {
+                        jobs->run(nested, [&] { count.fetch_add(1); });
+                    }
+                    jobs->wait(nested);
+                });
+            }
+            jobs->wait(group);
+        });
+    }
+
+    for (auto& t : submitters) {
+        t.join();
+    }
+
+    REQUIRE(count.load() == threads * outer * inner);
+    REQUIRE(jobs->stats().executed == threads * outer * (inner + 1));
+}
+
+TEST_CASE("job_system parallel_for") {
+    using namespace boken;
+
+    auto const jobs = make_job_system(3);
+
+    SECTION("index ranges") {
+        for (size_t const n : {size_t {0}, size_t {1}, size_t {7}, size_t {1000}}) {
+            std::vector<int> visits(n, 0);
+            std::atomic<bool> ok {true};
+
+            parallel_for(*jobs, n, 10, [&](size_t const first, size_t const last) {
+                if (last - first > 10) {
+                    ok = false;
+                }
+
+                for (auto i = first; i < last; ++i) {
+                    ++visits[i];
+                }
+            });
+
+            REQUIRE(ok.load());
+            REQUIRE(std::all_of(begin(visits), end(visits)
+              , [](int const v) { return v == 1; }));
+        }
+    }
+
+    SECTION("tiles") {
+        auto const area = recti32 {offi32x {3}, offi32y {5}, offi32x {40}, offi32y {29}};
+
+        std::vector<int> visits(100 * 100, 0);
+        std::atomic<int>  tiles {0};
+        std::atomic<bool> ok {true};
+
+        // Catch isn't thread safe; only check the results afterwards
+        parallel_for(*jobs, area, sizei32x {8}, sizei32y {8}, [&](recti32 const r) {
+            if (value_cast(r.width()) > 8 || value_cast(r.height()) > 8) {
+                ok = false;
+            }
+
+            for (auto y = value_cast(r.y0); y < value_cast(r.y1); ++y) {
+                for (auto x = value_cast(r.x0); x < value_cast(r.x1); ++x) {
+                    ++visits[static_cast<size_t>(y * 100 + x)];
+                }
+            }
+
+            ++tiles;
+        });
+
+        REQUIRE(ok.load());
+        REQUIRE(tiles.load() == 5 * 3);
+
+        for (int y = 0; y < 100; ++y) {
+            for (int x = 0; x < 100; ++x) {
+                auto const inside = x >= 3 && x < 40 && y >= 5 && y < 29;
+                REQUIRE(visits[static_cast<size_t>(y * 100 + x)] == (inside ? 1 : 0));
+            }
+        }
+    }
+}
+
+TEST_CASE("job_system profiler") {
+    using namespace boken;
+
+    auto const jobs = make_job_system(2);
+
+    std::mutex mutex;
+    std::vector<job_system::job_profile> profiles;
+
+    jobs->set_profiler([&](job_system::job_profile const& p) {
+        std::lock_guard<std::mutex> lock {mutex};
+        profiles.push_back(p);
+    });
+
+    task_group group;
+    for (uint32_t i = 0; i < 50; ++i) {
+        jobs->run(group, [] {}, i);
+    }
+    jobs->wait(group);
+
+    REQUIRE(profiles.size() == 50);
+    for (auto const& p : profiles) {
+        REQUIRE(p.worker <= 2);
+        REQUIRE(p.tag < 50);
+        REQUIRE(p.start <= p.end);
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
@@ -2,6 +2,325 @@
 #include "catch.hpp"
 #include "level.hpp"
 
+#include "data.hpp"
+#include "entity.hpp"
+#include "entity_def.hpp"
+#include "random.hpp"
+#include "world.hpp"
+#include "hash.hpp"
+#include "math.hpp"
+#include "rect.hpp"
 
+#include <algorithm>
+#include <vector>
+
+TEST_CASE("level tick_entities") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    auto const lvl = make_level(*rng, *w, sizei32x {50}, sizei32y {40}, 0);
+    auto const ctx = context {*w, *db};
+
+    auto const def = db->find(make_id<entity_id>("rat_small"));
+    REQUIRE(!!def);
+
+    // find three open tiles in a row
+    auto const is_open = [&](point2i32 const p) {
+        return lvl->can_place_entity_at(p) == placement_result::ok;
+    };
+
+    auto const v = vec2i32 {1, 0};
+
+    point2i32 p {0, 0};
+    for (auto y = 0; y < 40; ++y) {
+        for (auto x = 0; x < 48; ++x) {
+            auto const q = point2i32 {x, y};
+            if (is_open(q) && is_open(q + v) && is_open(q + v + v)) {
+                p = q;
+                break;
+            }
+        }
+    }
+
+    REQUIRE(is_open(p));
+
+    // a is added, and so comes due, first
+    auto const a = lvl->add_object_at(create_object(*db, *w, *def, *rng), p);
+    auto const b = lvl->add_object_at(create_object(*db, *w, *def, *rng), p + v + v);
+
+    REQUIRE(lvl->schedule_stats().scheduled == 2);
+
+    // both entities want the tile between them
+    auto const intent = [&](level::entity_intent* const first
+                          , level::entity_intent* const last) {
+        for (auto it = first; it != last; ++it) {
+            it->to    = p + v;
+            it->delay = it->id == a ? 10 : 0;
+        }
+    };
+
+    std::vector<placement_result> results;
+    auto const callback = [&](entity_descriptor, placement_result const r
+                            , point2i32, point2i32) {
+        results.push_back(r);
+    };
+
+    auto const stats = lvl->tick_entities(ctx, 1, intent, callback, {});
+
+    REQUIRE(stats.activated == 2);
+    REQUIRE(results == (std::vector<placement_result> {
+        placement_result::ok, placement_result::failed_entity}));
+
+    REQUIRE(require(lvl->find(a)) == p + v);
+    REQUIRE(require(lvl->find(b)) == p + v + v);
+
+    // b went to sleep; a acts again after its delay
+    REQUIRE(lvl->schedule_stats().scheduled == 1);
+    REQUIRE(lvl->tick_entities(ctx, 9, intent, callback, {}).activated == 0);
+    REQUIRE(lvl->tick_entities(ctx, 1, intent, callback, {}).activated == 1);
+
+    // waking b
+    lvl->schedule_entity(b, 0);
+    REQUIRE(lvl->tick_entities(ctx, 1, intent, callback, {}).activated == 1);
+
+    // removed entities are unscheduled
+    auto const removed = lvl->remove_entity(a);
+    REQUIRE(lvl->schedule_stats().scheduled == 0);
+}
+
+TEST_CASE("level continue_tick") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    auto const lvl = make_level(*rng, *w, sizei32x {50}, sizei32y {40}, 0);
+    auto const ctx = context {*w, *db};
+
+    auto const def = db->find(make_id<entity_id>("rat_small"));
+    REQUIRE(!!def);
+
+    std::vector<entity_instance_id> ids;
+    for (auto y = 0; y < 40 && ids.size() < 10; ++y) {
+        for (auto x = 0; x < 50 && ids.size() < 10; ++x) {
+            auto const p = point2i32 {x, y};
+            if (lvl->can_place_entity_at(p) == placement_result::ok) {
+                ids.push_back(lvl->add_object_at(create_object(*db, *w, *def, *rng), p));
+            }
+        }
+    }
+
+    REQUIRE(ids.size() == 10);
+
+    std::vector<entity_instance_id> order;
+    auto const intent = [&](level::entity_intent* const first
+                          , level::entity_intent* const last) {
+        for (auto it = first; it != last; ++it) {
+            order.push_back(it->id);
+            it->delay = 1;
+        }
+    };
+
+    auto const callback = [](entity_descriptor, placement_result, point2i32, point2i32) {};
+
+    REQUIRE(lvl->begin_tick(1) == 10);
+    REQUIRE(lvl->pending_tick() == 10);
+
+    // slices are processed in the order the entities came due
+    REQUIRE(lvl->continue_tick(ctx, 4, intent, callback, {}) == 6);
+    REQUIRE(std::equal(begin(order), end(order), begin(ids), begin(ids) + 4));
+
+    // entities removed in between slices are skipped
+    auto const removed = lvl->remove_entity(ids[5]);
+
+    REQUIRE(lvl->continue_tick(ctx, 4, intent, callback, {}) == 2);
+    REQUIRE(order.size() == 7);
+    REQUIRE(std::find(begin(order), end(order), ids[5]) == end(order));
+
+    REQUIRE(lvl->continue_tick(ctx, 4, intent, callback, {}) == 0);
+    REQUIRE(order.size() == 9);
+    REQUIRE(lvl->pending_tick() == 0);
+
+    // everything processed was rescheduled
+    REQUIRE(lvl->schedule_stats().scheduled == 9);
+    REQUIRE(lvl->begin_tick(1) == 9);
+}
+
+TEST_CASE("level activity") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    auto const lvl = make_level(*rng, *w, sizei32x {100}, sizei32y {80}, 0);
+
+    auto const def = db->find(make_id<entity_id>("rat_small"));
+    REQUIRE(!!def);
+
+    std::vector<std::pair<entity_instance_id, point2i32>> entities;
+    for (auto y = 0; y < 80; y += 3) {
+        for (auto x = 0; x < 100; x += 3) {
+            auto const p = point2i32 {x, y};
+            if (lvl->can_place_entity_at(p) == placement_result::ok) {
+                entities.push_back({
+                    lvl->add_object_at(create_object(*db, *w, *def, *rng), p), p});
+            }
+        }
+    }
+
+    auto const n = static_cast<uint32_t>(entities.size());
+    REQUIRE(n > 4);
+
+    // everything is active until an activity area is set
+    REQUIRE(lvl->activity().active  == n);
+    REQUIRE(lvl->activity().dormant == 0);
+
+    auto const corner = point2i32 {0, 0};
+    constexpr int32_t radius = 10;
+
+    // active if within the radius, or in a region adjacent to (or the same as)
+    // that of the center
+    auto const region_bounds = [&](region_id const id) {
+        for (size_t i = 0; i < lvl->region_count(); ++i) {
+            auto const r = lvl->region(i);
+            if (r.id == value_cast(id)) {
+                return r.bounds;
+            }
+        }
+        return recti32 {};
+    };
+
+    auto const is_empty = [](recti32 const r) {
+        return value_cast(r.area()) == 0;
+    };
+
+    auto const center_bounds = region_bounds(lvl->at(corner).rid);
+
+    auto const is_active = [&](point2i32 const p) {
+        if (value_cast(p.x) <= radius && value_cast(p.y) <= radius) {
+            return true;
+        }
+
+        auto const b = region_bounds(lvl->at(p).rid);
+        return !is_empty(center_bounds) && !is_empty(b)
+            && intersects(grow_rect(center_bounds), b);
+    };
+
+    auto const expected_active = static_cast<uint32_t>(std::count_if(
+        begin(entities), end(entities), [&](auto const& e) {
+            return is_active(e.second); }));
+
+    auto const far = *std::find_if(begin(entities), end(entities)
+      , [&](auto const& e) { return !is_active(e.second); });
+
+    auto const a = lvl->update_activity(corner, radius);
+    REQUIRE(a.active  == expected_active);
+    REQUIRE(a.dormant == n - expected_active);
+    REQUIRE(lvl->schedule_stats().scheduled == expected_active);
+
+    // dormant entities aren't activated
+    auto const ctx = context {*w, *db};
+    auto const intent = [](level::entity_intent*, level::entity_intent*) {};
+    auto const callback = [](entity_descriptor, placement_result, point2i32, point2i32) {};
+    REQUIRE(lvl->tick_entities(ctx, 1, intent, callback, {}).activated == expected_active);
+
+    // a noise wakes dormant entities
+    REQUIRE(lvl->wake_entities_near(far.second, 1, 100) == 1);
+    REQUIRE(lvl->activity().dormant == n - expected_active - 1);
+
+    // and they stay awake for the time given
+    lvl->update_activity(corner, radius - 1);
+    REQUIRE(lvl->tick_entities(ctx, 1, intent, callback, {}).activated == 1);
+    REQUIRE(lvl->tick_entities(ctx, 100, intent, callback, {}).activated == 0);
+    lvl->update_activity(corner, radius);
+    REQUIRE(lvl->activity().dormant == n - expected_active);
+
+    // removing an entity forgets it
+    auto const removed = lvl->remove_entity(far.first);
+    REQUIRE(lvl->activity().dormant == n - expected_active - 1);
+
+    // entities which leave the area by themselves go dormant, and those
+    // which enter it wake, even though the area hasn't moved
+    auto const near = *std::find_if(begin(entities), end(entities)
+      , [&](auto const& e) { return e.first != far.first && is_active(e.second); });
+
+    auto const dormant = lvl->activity().dormant;
+    REQUIRE(lvl->move_by(near.first, far.second - near.second) == placement_result::ok);
+    REQUIRE(lvl->update_activity(corner, radius).dormant == dormant + 1);
+
+    REQUIRE(lvl->move_by(near.first, near.second - far.second) == placement_result::ok);
+    REQUIRE(lvl->update_activity(corner, radius).dormant == dormant);
+
+    // the entities near a point are found by way of their chunks
+    auto const count_near = [&](point2i32 const p, int32_t const d) {
+        auto const r = grow_rect(recti32 {p, p}, d);
+        return std::count_if(begin(entities), end(entities), [&](auto const& e) {
+            return e.first != far.first && intersects(r, e.second); });
+    };
+
+    for (auto const d : {1, 5, 17, 40}) {
+        auto const found = lvl->entities_near(far.second, d);
+        REQUIRE(std::distance(found.first, found.second) == count_near(far.second, d));
+    }
+
+    // everything within range wakes
+    auto const b = lvl->update_activity(corner, 100);
+    REQUIRE(b.active  == n - 1);
+    REQUIRE(b.dormant == 0);
+}
+
+TEST_CASE("level simulate_coarse") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    auto const lvl = make_level(*rng, *w, sizei32x {50}, sizei32y {40}, 0);
+
+    auto const def = db->find(make_id<entity_id>("rat_small"));
+    REQUIRE(!!def);
+
+    std::vector<std::pair<entity_instance_id, point2i32>> entities;
+    for (auto y = 0; y < 40; y += 4) {
+        for (auto x = 0; x < 50; x += 4) {
+            auto const p = point2i32 {x, y};
+            if (lvl->can_place_entity_at(p) == placement_result::ok) {
+                entities.push_back({
+                    lvl->add_object_at(create_object(*db, *w, *def, *rng), p), p});
+            }
+        }
+    }
+
+    REQUIRE(entities.size() > 4);
+
+    lvl->simulate_coarse(*rng, 100);
+
+    // nothing is lost or duplicated, and everything ends up somewhere valid
+    size_t count = 0;
+    lvl->for_each_entity([&](entity_instance_id, point2i32) { ++count; });
+    REQUIRE(count == entities.size());
+
+    // ... and only where it could have walked to
+    auto moved = 0;
+    for (auto const& e : entities) {
+        auto const p = require(lvl->find(e.first));
+        REQUIRE(intersects(lvl->bounds(), p));
+        REQUIRE(require(lvl->entity_at(p)) == e.first);
+        if (p != e.second) {
+            ++moved;
+            auto const& path = lvl->find_path(e.second, p);
+            REQUIRE(!path.empty());
+            REQUIRE(path.back() == p);
+        }
+    }
+
+    REQUIRE(moved > 0);
+}
 
 #endif // !defined(BK_NO_TESTS)
@@ -20,6 +20,26 @@ TEST_CASE("clamp") {
     REQUIRE(bk::clamp(hi + 1, lo, hi) == hi    );
 }
 
+TEST_CASE("intersects rect") {
+    using namespace boken;
+
+    constexpr auto r = recti32 {offi32x {1}, offi32y {2}, offi32x {5}, offi32y {6}};
+
+    auto const make = [](int32_t const x0, int32_t const y0, int32_t const x1, int32_t const y1) {
+        return recti32 {offi32x {x0}, offi32y {y0}, offi32x {x1}, offi32y {y1}};
+    };
+
+    REQUIRE(intersects(r, r));
+    REQUIRE(intersects(r, make(4, 5, 10, 10)));
+    REQUIRE(intersects(make(0, 0, 10, 10), r));
+    REQUIRE(intersects(r, make(2, 0, 3, 10)));
+
+    // touching edges only
+    REQUIRE(!intersects(r, make(5, 2, 8, 6)));
+    REQUIRE(!intersects(r, make(1, 6, 5, 8)));
+    REQUIRE(!intersects(r, make(-5, -5, 1, 2)));
+}
+
 TEST_CASE("clamp rect") {
     using namespace boken;
 
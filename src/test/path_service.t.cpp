@@ -0,0 +1,97 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "path_service.hpp"
+
+#include "job_system.hpp"
+#include "level.hpp"
+#include "random.hpp"
+#include "world.hpp"
+
+#include <vector>
+
+TEST_CASE("path_service") {
+    using namespace boken;
+
+    auto const w    = make_world();
+    auto const rng  = make_random_state();
+    auto const jobs = make_job_system(2);
+
+    auto const lvl = make_level(*rng, *w, sizei32x {80}, sizei32y {60}, 0);
+
+    auto const paths = make_path_service(*jobs);
+
+    // the first and last open tiles
+    std::vector<point2i32> open;
+    for (auto y = 0; y < 60; ++y) {
+        for (auto x = 0; x < 80; ++x) {
+            auto const p = point2i32 {x, y};
+            if (lvl->can_place_entity_at(p) == placement_result::ok) {
+                open.push_back(p);
+            }
+        }
+    }
+
+    REQUIRE(open.size() >= 2);
+
+    auto const from = open.front();
+    auto const to   = open.back();
+
+    std::vector<point2i32> result;
+    int calls = 0;
+
+    auto const on_complete = [&](path_service::request_id
+                               , std::vector<point2i32> const& path) {
+        result = path;
+        ++calls;
+    };
+
+    SECTION("the same path as the level finds") {
+        auto const id = paths->request(*lvl, from, to, on_complete);
+        REQUIRE(id != 0);
+        REQUIRE(paths->pending() == 1);
+
+        paths->wait();
+        REQUIRE(calls == 0); // only delivered by poll
+
+        REQUIRE(paths->poll() == 1);
+        REQUIRE(calls == 1);
+        REQUIRE(paths->pending() == 0);
+
+        auto const& expected = lvl->find_path(from, to);
+        REQUIRE(!result.empty());
+        REQUIRE(result == expected);
+        REQUIRE(result.front() == from);
+
+        REQUIRE(paths->poll() == 0);
+    }
+
+    SECTION("cancelled requests aren't delivered") {
+        auto const a = paths->request(*lvl, from, to, on_complete);
+        auto const b = paths->request(*lvl, to, from, on_complete);
+        REQUIRE(a != b);
+
+        REQUIRE(paths->cancel(a));
+        REQUIRE(!paths->cancel(a));
+        REQUIRE(paths->pending() == 1);
+
+        paths->wait();
+        REQUIRE(paths->poll() == 1);
+        REQUIRE(calls == 1);
+        REQUIRE(result.front() == to);
+
+        REQUIRE(!paths->cancel(b));
+    }
+
+    SECTION("cancel all") {
+        paths->request(*lvl, from, to, on_complete);
+        paths->request(*lvl, to, from, on_complete);
+        paths->cancel_all();
+        REQUIRE(paths->pending() == 0);
+
+        paths->wait();
+        REQUIRE(paths->poll() == 0);
+        REQUIRE(calls == 0);
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
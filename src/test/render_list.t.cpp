@@ -0,0 +1,220 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "render_list.hpp"
+
+#include "software_renderer.hpp"
+#include "text.hpp"
+
+#include <vector>
+
+namespace {
+
+struct tile_data_t {
+    boken::point2i16 position;
+    boken::point2i16 tex_coord;
+    uint32_t         color;
+};
+
+boken::point2i16 p16(int const x, int const y) noexcept {
+    return {static_cast<int16_t>(x), static_cast<int16_t>(y)};
+}
+
+std::vector<uint32_t> make_texture_pixels(int const w, int const h) {
+    std::vector<uint32_t> result;
+    for (auto i = 0; i < w * h; ++i) {
+        result.push_back(0x80000000u | (static_cast<uint32_t>(i) * 2654435761u));
+    }
+
+    return result;
+}
+
+std::unique_ptr<boken::software_renderer> make_renderer() {
+    using namespace boken;
+
+    auto r = make_software_renderer(sizei32x {96}, sizei32y {64});
+    r->add_texture(sizei32x {32}, sizei32y {32}, make_texture_pixels(32, 32));
+    r->set_background(
+        r->add_texture(sizei32x {7}, sizei32y {5}, make_texture_pixels(7, 5)));
+
+    return r;
+}
+
+//! Draw a bit of everything; @p frame varies it a little.
+void draw_scene(boken::renderer2d& r, int const frame) {
+    using namespace boken;
+    using ptr_t = read_only_pointer_t;
+
+    r.transform();
+    r.draw_background();
+
+    std::vector<tile_data_t> const tiles {
+        {p16(frame, 0),  p16(0, 0),  0xFFFFFFFFu}
+      , {p16(20, 10),    p16(8, 8),  0xFF4080C0u}
+      , {p16(40, 30),    p16(16, 0), 0xFF00FF00u}};
+
+    {
+        auto const trans = r.transform({1.5f, 1.5f, 6.0f, -3.0f});
+        r.draw_tiles(renderer2d::tile_params_uniform {
+            sizei32x {8}, sizei32y {8}, 0, static_cast<int32_t>(tiles.size())
+          , ptr_t {tiles, offsetof(tile_data_t, position)}
+          , ptr_t {tiles, offsetof(tile_data_t, tex_coord)}
+          , ptr_t {tiles, offsetof(tile_data_t, color)}});
+    }
+
+    auto const clip = r.clip_rect({point2i32 {4, 4}, point2i32 {60, 40}});
+
+    recti32 const rects[] {
+        {point2i32 {0, 0},   point2i32 {10 + frame, 10}}
+      , {point2i32 {30, 20}, point2i32 {70, 50}}};
+    uint32_t const colors[] {0x80FF0000u, 0xC00000FFu};
+
+    r.fill_rects(std::begin(rects), std::end(rects), std::begin(colors), std::end(colors));
+    r.draw_rect({point2i32 {8, 8}, point2i32 {30, 30}}, 2, 0xFFFFFF00u);
+
+    // into a target, then from it
+    auto const target = r.create_target(sizei32x {16}, sizei32y {16});
+    r.set_target(target);
+    r.fill_rect({point2i32 {2, 2}, point2i32 {14, 14}}, 0xFF123456u);
+    r.set_target(renderer2d::screen_target);
+
+    std::vector<tile_data_t> const copy {{p16(50, 4), p16(0, 0), 0xFFFFFFFFu}};
+    r.draw_tiles(renderer2d::tile_params_uniform {
+        sizei32x {16}, sizei32y {16}, target, 1
+      , ptr_t {copy, offsetof(tile_data_t, position)}
+      , ptr_t {copy, offsetof(tile_data_t, tex_coord)}
+      , ptr_t {copy, offsetof(tile_data_t, color)}});
+}
+
+class scene_task final : public boken::render_task {
+public:
+    void render(duration_t, boken::renderer2d& r, boken::view const&) final override {
+        draw_scene(r, frame++);
+    }
+
+    // what is drawn changes every frame
+    uint32_t generation() const noexcept final override {
+        return static_cast<uint32_t>(frame);
+    }
+
+    int frame = 0;
+};
+
+class counting_task final : public boken::render_task {
+public:
+    void render(duration_t, boken::renderer2d& r, boken::view const&) final override {
+        r.fill_rect({boken::point2i32 {1, 1}, boken::point2i32 {5, 5}}, 0xFF00FF00u);
+        ++renders;
+    }
+
+    uint32_t generation() const noexcept final override {
+        return gen;
+    }
+
+    uint32_t gen     = 0;
+    int      renders = 0;
+};
+
+} // namespace
+
+TEST_CASE("render_list") {
+    using namespace boken;
+
+    auto const direct = make_renderer();
+    direct->render_clear();
+    draw_scene(*direct, 0);
+
+    auto const replayed = make_renderer();
+    render_list list {*replayed, [] {}};
+
+    list.reset(replayed->get_client_rect());
+    draw_scene(list, 0);
+    REQUIRE(list.size() > 0);
+
+    // nothing is drawn until the list is replayed
+    replayed->render_clear();
+    auto const cleared = replayed->pixels();
+
+    replayed->transform();
+    list.replay();
+
+    REQUIRE(replayed->pixels() != cleared);
+    REQUIRE(replayed->pixels() == direct->pixels());
+
+    // the data drawn was copied, and so can be replayed again
+    replayed->render_clear();
+    replayed->transform();
+    list.replay();
+    REQUIRE(replayed->pixels() == direct->pixels());
+
+    list.reset(replayed->get_client_rect());
+    REQUIRE(list.size() == 0);
+}
+
+TEST_CASE("game_renderer with a render thread") {
+    using namespace boken;
+
+    auto const trender = make_text_renderer();
+
+    auto  r   = make_renderer();
+    auto& out = *r;
+
+    auto const gr = make_game_renderer(std::move(r), *trender);
+    gr->add_task("scene", std::make_unique<scene_task>(), 0);
+
+    auto const expected = make_renderer();
+
+    for (int frame = 0; frame < 3; ++frame) {
+        gr->render(render_task::duration_t {}, view {});
+        gr->wait();
+
+        // the game renderer draws the background before any task
+        expected->render_clear();
+        expected->draw_background();
+        draw_scene(*expected, frame);
+
+        REQUIRE(out.pixels() == expected->pixels());
+    }
+
+    REQUIRE(gr->frame_stats().counts.tiles > 0);
+    REQUIRE(gr->frame_counts().drawn == 3);
+    REQUIRE(gr->frame_counts().skipped == 0);
+}
+
+TEST_CASE("game_renderer skips unchanged frames") {
+    using namespace boken;
+
+    auto const trender = make_text_renderer();
+    auto const gr      = make_game_renderer(make_renderer(), *trender);
+    auto&      task    = gr->add_task("count", std::make_unique<counting_task>(), 0);
+
+    auto const render = [&](view const& v) {
+        auto const result = gr->render(render_task::duration_t {}, v);
+        gr->wait();
+        return result;
+    };
+
+    view v;
+
+    REQUIRE(render(v));
+    REQUIRE(!render(v));
+    REQUIRE(!render(v));
+    REQUIRE(task.renders == 1);
+
+    // the task changed
+    ++task.gen;
+    REQUIRE(render(v));
+    REQUIRE(!render(v));
+
+    // the view moved, then scaled
+    v.x_off = 10.0f;
+    REQUIRE(render(v));
+    v.scale_x = 2.0f;
+    REQUIRE(render(v));
+    REQUIRE(!render(v));
+
+    REQUIRE(task.renders == 4);
+    REQUIRE(gr->frame_counts().drawn   == 4);
+    REQUIRE(gr->frame_counts().skipped == 4);
+}
+
+#endif // !defined(BK_NO_TESTS)
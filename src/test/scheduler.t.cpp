@@ -0,0 +1,91 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "scheduler.hpp"
+
+#include <vector>
+
+TEST_CASE("actor_scheduler") {
+    using namespace boken;
+
+    actor_scheduler<int> s;
+
+    std::vector<int> order;
+    auto const record = [&](uint64_t const delay) {
+        return [&, delay](int const id) {
+            order.push_back(id);
+            return delay;
+        };
+    };
+
+    s.schedule(1, 10);
+    s.schedule(2, 5);
+    s.schedule(3, 5);
+
+    REQUIRE(s.size() == 3);
+
+    SECTION("only due actors are activated, in time order") {
+        REQUIRE(s.advance(4, record(0)) == 0);
+        REQUIRE(s.advance(1, record(0)) == 2);
+        REQUIRE(order == (std::vector<int> {2, 3}));
+        REQUIRE(s.size() == 1);
+
+        REQUIRE(s.advance(10, record(0)) == 1);
+        REQUIRE(order == (std::vector<int> {2, 3, 1}));
+        REQUIRE(s.empty());
+        REQUIRE(s.stats().total_activated == 3);
+    }
+
+    SECTION("actors are rescheduled relative to the time they were due") {
+        // 2 and 3 are due at 5, 10, 15, 20; 1 at 10, 15, 20
+        REQUIRE(s.advance(20, record(5)) == 4 * 2 + 3);
+        REQUIRE(s.size() == 3);
+        REQUIRE(s.stats().now == 20);
+    }
+
+    SECTION("rescheduling replaces the existing schedule") {
+        s.schedule(2, 20);
+        REQUIRE(s.advance(10, record(0)) == 2);
+        REQUIRE(order == (std::vector<int> {3, 1}));
+        REQUIRE(s.stats().discarded == 1);
+        REQUIRE(s.is_scheduled(2));
+    }
+
+    SECTION("unscheduled actors are never activated") {
+        REQUIRE(s.unschedule(2));
+        REQUIRE(!s.unschedule(2));
+        REQUIRE(s.advance(10, record(0)) == 2);
+        REQUIRE(order == (std::vector<int> {3, 1}));
+    }
+
+    SECTION("take_due leaves actors to be rescheduled by the caller") {
+        std::vector<std::pair<int, uint64_t>> due;
+        REQUIRE(s.take_due(7, due) == 2);
+        REQUIRE(due == (std::vector<std::pair<int, uint64_t>> {{2, 5}, {3, 5}}));
+        REQUIRE(s.size() == 1);
+
+        s.schedule_at(2, due[0].second + 5); // at 10
+        s.schedule_at(3, 0);                 // in the past ~> next tick
+
+        REQUIRE(s.advance(1, record(0)) == 1);
+        REQUIRE(s.advance(2, record(0)) == 2);
+        REQUIRE(order == (std::vector<int> {3, 1, 2}));
+    }
+
+    SECTION("actors can be woken from a callback") {
+        s.advance(5, [&](int const id) -> uint64_t {
+            if (id == 2) {
+                s.unschedule(1);
+                s.schedule(4, 1);
+            }
+            order.push_back(id);
+            return 0;
+        });
+
+        REQUIRE(order == (std::vector<int> {2, 3}));
+        REQUIRE(s.size() == 1);
+        REQUIRE(s.advance(1, record(0)) == 1);
+        REQUIRE(order.back() == 4);
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
@@ -0,0 +1,234 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "software_renderer.hpp"
+#include "software_renderer.t.hpp"
+
+#include "level.hpp"
+#include "random.hpp"
+#include "tile.hpp"
+#include "world.hpp"
+
+#include <set>
+#include <vector>
+
+namespace {
+
+//! The blending rule documented in software_renderer.hpp, a channel at a time.
+uint32_t reference_blend(uint32_t const src, uint32_t const dst, uint32_t const mod) noexcept {
+    auto const ch = [](uint32_t const c, int const i) noexcept {
+        return static_cast<double>((c >> (i * 8)) & 0xFFu);
+    };
+
+    auto const round = [](double const x) noexcept {
+        return static_cast<uint32_t>(x + 0.5);
+    };
+
+    auto const sa = ch(src, 3);
+
+    uint32_t result = 0;
+    for (int i = 0; i < 3; ++i) {
+        auto const c = round(ch(src, i) * ch(mod, i) / 255.0);
+        result |= (round(c * sa / 255.0) + round(ch(dst, i) * (255.0 - sa) / 255.0)) << (i * 8);
+    }
+
+    return result | ((static_cast<uint32_t>(sa) + round(ch(dst, 3) * (255.0 - sa) / 255.0)) << 24);
+}
+
+template <typename T>
+boken::renderer2d::tile_params_uniform make_tiles(
+    boken::sizei32x const w
+  , boken::sizei32y const h
+  , uint32_t        const texture_id
+  , std::vector<T>  const& data
+) {
+    using ptr_t = boken::read_only_pointer_t;
+    return {w, h, texture_id, static_cast<int32_t>(data.size())
+          , ptr_t {data, offsetof(T, position)}
+          , ptr_t {data, offsetof(T, tex_coord)}
+          , ptr_t {data, offsetof(T, color)}};
+}
+
+boken::point2i16 p16(int const x, int const y) noexcept {
+    return {static_cast<int16_t>(x), static_cast<int16_t>(y)};
+}
+
+struct tile_data_t {
+    boken::point2i16 position;
+    boken::point2i16 tex_coord;
+    uint32_t         color;
+};
+
+} // namespace
+
+TEST_CASE("software_renderer") {
+    using namespace boken;
+
+    auto const rng = make_random_state();
+    auto const r   = make_software_renderer(sizei32x {64}, sizei32y {48});
+
+    auto const at = [&](int const x, int const y) {
+        return r->pixels()[static_cast<size_t>(x + y * 64)];
+    };
+
+    r->render_clear();
+    REQUIRE(r->get_client_rect() == recti32 {point2i32 {}, sizei32x {64}, sizei32y {48}});
+    REQUIRE(at(0, 0) == 0xFF007F7Fu);
+    REQUIRE(at(63, 47) == 0xFF007F7Fu);
+
+    SECTION("fill_rect blends and is clipped") {
+        r->fill_rect({point2i32 {-4, -4}, point2i32 {8, 8}}, 0xFF0000FFu);
+        REQUIRE(at(0, 0) == 0xFF0000FFu);
+        REQUIRE(at(7, 7) == 0xFF0000FFu);
+        REQUIRE(at(8, 8) == 0xFF007F7Fu);
+
+        r->fill_rect({point2i32 {0, 0}, point2i32 {2, 2}}, 0x80FF0000u);
+        REQUIRE(at(0, 0) == reference_blend(0x80FF0000u, 0xFF0000FFu, 0xFFFFFFFFu));
+
+        auto const clip = r->clip_rect({point2i32 {10, 10}, point2i32 {12, 12}});
+        r->fill_rect({point2i32 {0, 0}, point2i32 {64, 48}}, 0xFF00FF00u);
+        REQUIRE(at(10, 10) == 0xFF00FF00u);
+        REQUIRE(at(11, 11) == 0xFF00FF00u);
+        REQUIRE(at(12, 12) == 0xFF007F7Fu);
+        REQUIRE(at(9, 10)  == 0xFF007F7Fu);
+    }
+
+    SECTION("draw_rect and the transform") {
+        auto const trans = r->transform({2.0f, 2.0f, 8.0f, 0.0f});
+
+        // translated by 4 (8 / 2), then scaled by 2
+        r->draw_rect({point2i32 {0, 0}, point2i32 {4, 4}}, 1, 0xFFFFFFFFu);
+        REQUIRE(at(8,  0) == 0xFFFFFFFFu);
+        REQUIRE(at(9,  1) == 0xFFFFFFFFu);
+        REQUIRE(at(15, 7) == 0xFFFFFFFFu);
+        REQUIRE(at(10, 2) == 0xFF007F7Fu); // inside the border
+        REQUIRE(at(7,  0) == 0xFF007F7Fu);
+    }
+
+    SECTION("draw_tiles matches the blending rule") {
+        // 37 is deliberately not a multiple of the 4 pixels blended at once
+        auto const w = 37;
+        auto const h = 5;
+
+        auto const backdrop = r->add_texture(sizei32x {w}, sizei32y {h}
+          , make_random_pixels(*rng, static_cast<size_t>(w * h), true));
+        auto const texels = make_random_pixels(*rng, static_cast<size_t>(w * h), false);
+        auto const tex    = r->add_texture(sizei32x {w}, sizei32y {h}, texels);
+
+        std::vector<tile_data_t> const tiles {{p16(3, 2), p16(0, 0), 0xFFFFFFFFu}};
+        r->draw_tiles(make_tiles(sizei32x {w}, sizei32y {h}, backdrop, tiles));
+
+        std::vector<uint32_t> before;
+        for (auto y = 0; y < h; ++y) {
+            for (auto x = 0; x < w; ++x) {
+                before.push_back(at(x + 3, y + 2));
+            }
+        }
+
+        auto const color = 0xFF30A0E0u;
+        std::vector<tile_data_t> const top {{p16(3, 2), p16(0, 0), color}};
+        r->draw_tiles(make_tiles(sizei32x {w}, sizei32y {h}, tex, top));
+
+        for (auto y = 0; y < h; ++y) {
+            for (auto x = 0; x < w; ++x) {
+                auto const i = static_cast<size_t>(x + y * w);
+                REQUIRE(at(x + 3, y + 2) == reference_blend(texels[i], before[i], color));
+            }
+        }
+
+        auto const stats = r->stats();
+        REQUIRE(stats.draw_calls == 2);
+        REQUIRE(stats.tiles == 2);
+    }
+
+    SECTION("targets") {
+        REQUIRE(r->has_targets());
+
+        auto const target = r->create_target(sizei32x {4}, sizei32y {4});
+
+        auto const trans = r->transform({1.0f, 1.0f, 10.0f, 10.0f});
+
+        r->set_target(target);
+        r->fill_rect({point2i32 {1, 1}, point2i32 {3, 3}}, 0xFFFFFFFFu);
+        r->set_target(renderer2d::screen_target);
+
+        // nothing was drawn to the window
+        REQUIRE(at(1, 1) == 0xFF007F7Fu);
+
+        std::vector<tile_data_t> const tiles {{p16(0, 0), p16(0, 0), 0xFFFFFFFFu}};
+        r->draw_tiles(make_tiles(sizei32x {4}, sizei32y {4}, target, tiles));
+
+        // the transform was restored; the transparent border left as is
+        REQUIRE(at(10, 10) == 0xFF007F7Fu);
+        REQUIRE(at(11, 11) == 0xFFFFFFFFu);
+        REQUIRE(at(12, 12) == 0xFFFFFFFFu);
+        REQUIRE(at(13, 13) == 0xFF007F7Fu);
+
+        REQUIRE(r->enable_targets(false));
+        REQUIRE(!r->has_targets());
+    }
+}
+
+TEST_CASE("software_renderer map") {
+    using namespace boken;
+
+    headless_map m {sizei32x {640}, sizei32y {480}};
+
+    // the terrain drawn from the cached chunks is identical to the terrain
+    // drawn a tile at a time
+    auto const check = [&](view const& v) {
+        m.r->enable_targets(true);
+        auto const cached = m.render(v);
+
+        m.r->enable_targets(false);
+        auto const direct = m.render(v);
+
+        REQUIRE(cached == direct);
+    };
+
+    view v;
+
+    SECTION("unscaled") {
+        v.x_off = -100.0f;
+        v.y_off = -37.0f;
+        check(v);
+    }
+
+    SECTION("scaled") {
+        v.x_off   = 50.0f;
+        v.y_off   = -211.0f;
+        v.scale_x = 1.5f;
+        v.scale_y = 1.5f;
+        check(v);
+    }
+
+    SECTION("after a change to part of the level") {
+        v.x_off = -100.0f;
+        v.y_off = -37.0f;
+        m.render(v);
+
+        auto const area = recti32 {point2i32 {10, 10}, point2i32 {20, 14}};
+        m.map->update_map_data(m.lvl->tile_ids(area));
+
+        check(v);
+    }
+
+    SECTION("tiles of a color are drawn as a run") {
+        // a color for each region
+        m.map->debug_toggle_show_regions();
+        m.map->update_map_data();
+
+        auto const rids = m.lvl->region_ids(m.lvl->bounds());
+        std::set<region_id> const regions(rids.first, rids.second);
+
+        m.r->enable_targets(false);
+        m.render(v);
+
+        // a change for each color of terrain at most, then one for the color
+        // of items, and one each for the texture and color of entities
+        auto const stats = m.r->stats();
+        REQUIRE(stats.tiles > regions.size() * 4u);
+        REQUIRE(stats.state_changes <= regions.size() + 4u);
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
@@ -0,0 +1,88 @@
+#pragma once
+
+//
+// A renderer drawing a level off screen, shared by the software_renderer
+// tests and benchmarks.
+//
+
+#include "software_renderer.hpp"
+
+#include "level.hpp"
+#include "random.hpp"
+#include "tile.hpp"
+#include "world.hpp"
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace boken {
+
+//! @p n random pixels; all of them opaque if @p opaque.
+inline std::vector<uint32_t> make_random_pixels(
+    random_state& rng
+  , size_t        const n
+  , bool          const opaque
+) {
+    std::vector<uint32_t> result(n);
+    for (auto& p : result) {
+        p = static_cast<uint32_t>(random_uniform_int(rng, 0, 0x7FFFFFFF)) * 2u
+          + static_cast<uint32_t>(random_uniform_int(rng, 0, 1));
+        if (opaque) {
+            p |= 0xFF000000u;
+        }
+    }
+
+    return result;
+}
+
+//! A level and some entities drawn by a software_renderer.
+struct headless_map {
+    headless_map(sizei32x const win_w, sizei32y const win_h)
+      : r {make_software_renderer(win_w, win_h)}
+    {
+        r->add_texture(sizei32x {16 * 18}, sizei32y {16 * 18}
+          , make_random_pixels(*rng, 16 * 18 * 16 * 18, true));
+        r->add_texture(sizei32x {26 * 18}, sizei32y {17 * 18}
+          , make_random_pixels(*rng, 26 * 18 * 17 * 18, false));
+
+        map->set_tile_maps({{tile_map_type::base,   tmap_base}
+                          , {tile_map_type::entity, tmap_entities}
+                          , {tile_map_type::item,   tmap_items}});
+        map->set_level(*lvl);
+        map->update_map_data();
+
+        for (auto i = 0; i < 200; ++i) {
+            map->add_object_at(
+                point2i32 {random_uniform_int(*rng, 0, value_cast(lvl->width())  - 1)
+                         , random_uniform_int(*rng, 0, value_cast(lvl->height()) - 1)}
+              , entity_id {static_cast<uint32_t>(i + 1)});
+        }
+    }
+
+    std::vector<uint32_t> const& render(view const& v) {
+        r->render_clear();
+        r->transform();
+        map->render(render_task::duration_t {}, *r, v);
+        return r->pixels();
+    }
+
+    std::unique_ptr<random_state>      rng = make_random_state();
+    std::unique_ptr<world>             w   = make_world();
+    std::unique_ptr<level>             lvl = make_level(
+        *rng, *w, sizei32x {80}, sizei32y {60}, 0);
+    std::unique_ptr<software_renderer> r;
+    std::unique_ptr<map_renderer>      map = make_map_renderer();
+
+    tile_map tmap_base {tile_map_type::base, 0
+      , sizei32x {18}, sizei32y {18}
+      , sizei32x {16}, sizei32y {16}};
+    tile_map tmap_entities {tile_map_type::entity, 1
+      , sizei32x {18}, sizei32y {18}
+      , sizei32x {26}, sizei32y {17}};
+    tile_map tmap_items {tile_map_type::item, 0
+      , sizei32x {18}, sizei32y {18}
+      , sizei32x {16}, sizei32y {16}};
+};
+
+} // namespace boken
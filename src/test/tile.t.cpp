@@ -0,0 +1,51 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "tile.hpp"
+
+namespace {
+
+//! The coordinates as they were found before tile_map::tex_coord.
+template <typename Id>
+boken::point2i16 slow_tex_coord(boken::tile_map const& tmap, Id const id) noexcept {
+    return boken::underlying_cast_unsafe<int16_t>(
+        tmap.index_to_rect(boken::id_to_index(tmap, id)).top_left());
+}
+
+} // namespace
+
+TEST_CASE("tile_map tex_coord") {
+    using namespace boken;
+
+    tile_map tmap {tile_map_type::entity, 0
+      , sizei32x {18}, sizei32y {18}, sizei32x {26}, sizei32y {17}};
+
+    SECTION("tile ids") {
+        for (auto const id : {tile_id::empty, tile_id::floor, tile_id::wall_1011
+                            , tile_id::door_ew_open, tile_id::stair_up}) {
+            REQUIRE(tmap.tex_coord(id) == slow_tex_coord(tmap, id));
+        }
+
+        // unknown ids are given the first tile
+        REQUIRE(tmap.tex_coord(tile_id::invalid) == point2i16 {});
+    }
+
+    SECTION("mapped ids") {
+        tmap.add_mapping(entity_id {djb2_hash_32c("rat")}, 351);
+        tmap.add_mapping(entity_id {djb2_hash_32c("bat")}, 177);
+
+        auto const rat = entity_id {djb2_hash_32c("rat")};
+        auto const bat = entity_id {djb2_hash_32c("bat")};
+        auto const cat = entity_id {djb2_hash_32c("cat")};
+
+        REQUIRE(tmap.tex_coord(rat) == slow_tex_coord(tmap, rat));
+        REQUIRE(tmap.tex_coord(bat) == slow_tex_coord(tmap, bat));
+        REQUIRE(tmap.tex_coord(cat) == point2i16 {});
+
+        // the table is made again after a change
+        tmap.add_mapping(cat, 27);
+        REQUIRE(tmap.tex_coord(cat) == slow_tex_coord(tmap, cat));
+        REQUIRE(tmap.tex_coord(cat) != point2i16 {});
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
@@ -0,0 +1,73 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "timer.hpp"
+
+TEST_CASE("timer") {
+    using namespace boken;
+    using namespace std::chrono;
+
+    timer timers;
+
+    REQUIRE(timers.next_deadline() == timer::time_point::max());
+    REQUIRE(timers.update() == 0);
+
+    int fired = 0;
+
+    auto const before = timer::clock_t::now();
+    timers.add(1u, timer::duration {0}, [&](timer::duration, timer::timer_data&) {
+        ++fired;
+        return timer::duration {0};
+    });
+
+    timers.add(2u, hours {1}, [&](timer::duration, timer::timer_data&) {
+        ++fired;
+        return timer::duration {0};
+    });
+
+    // the earliest deadline is the one already passed
+    REQUIRE(timers.next_deadline() <= timer::clock_t::now());
+    REQUIRE(timers.next_deadline() >= before);
+
+    REQUIRE(timers.update() == 1);
+    REQUIRE(fired == 1);
+
+    // only the timer an hour away is left
+    REQUIRE(timers.next_deadline() >= before + hours {1});
+    REQUIRE(timers.update() == 0);
+
+    REQUIRE(timers.remove(2u));
+    REQUIRE(timers.next_deadline() == timer::time_point::max());
+
+    SECTION("timers added by a callback") {
+        int added = 0;
+
+        timers.add(3u, timer::duration {0}, [&](timer::duration, timer::timer_data&) {
+            timers.add(4u, timer::duration {0}, [&](timer::duration, timer::timer_data&) {
+                ++added;
+                return timer::duration {0};
+            });
+
+            timers.add(5u, timer::duration {0}, [&](timer::duration, timer::timer_data&) {
+                ++added;
+                return timer::duration {0};
+            });
+
+            // removed before it ever runs
+            REQUIRE(timers.remove(5u));
+
+            ++fired;
+            return timer::duration {0};
+        });
+
+        // the new timer waits for the next update
+        REQUIRE(timers.update() == 1);
+        REQUIRE(fired == 2);
+        REQUIRE(added == 0);
+
+        REQUIRE(timers.update() == 1);
+        REQUIRE(added == 1);
+        REQUIRE(timers.next_deadline() == timer::time_point::max());
+    }
+}
+
+#endif // !defined(BK_NO_TESTS)
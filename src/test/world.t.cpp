@@ -0,0 +1,54 @@
+#if !defined(BK_NO_TESTS)
+#include "catch.hpp"
+#include "world.hpp"
+
+#include "data.hpp"
+#include "item.hpp"
+#include "item_def.hpp"
+#include "item_properties.hpp"
+#include "random.hpp"
+#include "context.hpp"
+#include "hash.hpp"
+
+#include <vector>
+
+TEST_CASE("world create_objects") {
+    using namespace boken;
+
+    auto const db  = make_game_database();
+    auto const w   = make_world();
+    auto const rng = make_random_state();
+
+    item_definition def {"test_stackable", make_id<item_id>("test_stackable")};
+    def.properties.add_or_update_property(make_id<item_property_id>("stack_size"), 10);
+    def.update_slots();
+
+    std::vector<unique_item> items;
+    items.push_back(create_object(*db, *w, def, *rng));
+
+    constexpr size_t n = 100;
+    create_objects(*db, *w, def, *rng, n, items);
+
+    REQUIRE(items.size() == n + 1);
+
+    for (auto const& i : items) {
+        REQUIRE(!!i);
+        auto const& itm = w->find(i.get());
+        REQUIRE(itm.instance() == i.get());
+        REQUIRE(itm.definition() == def.id);
+        REQUIRE(current_stack_size(const_item_descriptor {itm, def}) == 1);
+    }
+
+    // ids are unique
+    for (size_t i = 1; i < items.size(); ++i) {
+        REQUIRE(items[i - 1].get() != items[i].get());
+    }
+
+    // released blocks are reused by the next batch
+    auto const reused = items.back().get();
+    items.pop_back();
+    create_objects(*db, *w, def, *rng, 1, items);
+    REQUIRE(items.back().get() == reused);
+}
+
+#endif // !defined(BK_NO_TESTS)
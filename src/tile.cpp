@@ -2,8 +2,25 @@
 
 #include <bkassert/assert.hpp>
 
+#include <iterator>
+
 namespace boken {
 
+namespace {
+
+constexpr tile_id all_tile_ids[] {
+    tile_id::empty, tile_id::floor, tile_id::tunnel
+  , tile_id::wall_0000, tile_id::wall_0001, tile_id::wall_0010, tile_id::wall_0011
+  , tile_id::wall_0100, tile_id::wall_0101, tile_id::wall_0110, tile_id::wall_0111
+  , tile_id::wall_1000, tile_id::wall_1001, tile_id::wall_1010, tile_id::wall_1011
+  , tile_id::wall_1100, tile_id::wall_1101, tile_id::wall_1110, tile_id::wall_1111
+  , tile_id::door_ns_closed, tile_id::door_ns_open
+  , tile_id::door_ew_closed, tile_id::door_ew_open
+  , tile_id::stair_down, tile_id::stair_up
+};
+
+} // namespace
+
 tile_map::tile_map(
     tile_map_type const type
   , uint32_t      const texture_id
@@ -11,7 +28,7 @@ tile_map::tile_map(
   , sizei32y      const tile_h
   , sizei32x      const tiles_x
   , sizei32y      const tiles_y
-) noexcept
+)
   : type_       {type}
   , texture_id_ {texture_id}
   , tile_w_     {tile_w}
@@ -23,6 +40,29 @@ tile_map::tile_map(
     BK_ASSERT_SAFE(value_cast(tile_h)  > 0);
     BK_ASSERT_SAFE(value_cast(tiles_x) > 0);
     BK_ASSERT_SAFE(value_cast(tiles_y) > 0);
+
+    tile_coords_.reserve(static_cast<size_t>(
+        std::distance(std::begin(all_tile_ids), std::end(all_tile_ids))));
+    for (auto const id : all_tile_ids) {
+        tile_coords_.insert(static_cast<uint32_t>(id)
+                          , index_to_coord_(id_to_index(*this, id)));
+    }
+
+    tile_coords_.freeze();
+}
+
+void tile_map::update_mapped_coords_() const {
+    coord_table table;
+    table.reserve(mappings_.size());
+
+    for (auto const& m : mappings_) {
+        table.insert(m.first, index_to_coord_(m.second));
+    }
+
+    table.freeze();
+
+    mapped_coords_       = std::move(table);
+    mapped_coords_stale_ = false;
 }
 
 template <>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "config.hpp"
+#include "flat_table.hpp"
 #include "hash.hpp"
 #include "math_types.hpp"
 #include "types.hpp"
@@ -111,7 +112,7 @@ public:
       , sizei32y      tile_h
       , sizei32x      tiles_x
       , sizei32y      tiles_y
-    ) noexcept;
+    );
 
     recti32 index_to_rect(uint32_t const i) const noexcept {
         auto const tx = value_cast_unsafe<uint32_t>(tiles_x_);
@@ -130,10 +131,32 @@ public:
 
     uint32_t texture_id() const noexcept { return texture_id_; }
 
+    //! The top left of the tile for @p id within the texture; that of the
+    //! tile at index 0 if there is none.
+    //! @note Both this, and the overload for mapped ids, look up a table of
+    //!       coordinates made ahead of time; i.e. a multiply, a load and a
+    //!       compare, rather than the hashing of find and the division of
+    //!       index_to_rect.
+    point2i16 tex_coord(tile_id const id) const noexcept {
+        return lookup_(tile_coords_, static_cast<uint32_t>(id));
+    }
+
+    //! @see tex_coord(tile_id); the table is made again by the first lookup
+    //! after a mapping is added.
+    template <typename T, typename Tag>
+    point2i16 tex_coord(tagged_value<T, Tag> const id) const {
+        if (mapped_coords_stale_) {
+            update_mapped_coords_();
+        }
+
+        return lookup_(mapped_coords_, value_cast(id));
+    }
+
     //TODO remove these
     template <typename T, typename Tag>
     void add_mapping(tagged_value<T, Tag> const id, uint32_t const index) {
         mappings_.insert(std::make_pair(value_cast(id), index));
+        mapped_coords_stale_ = true;
     }
 
     template <typename T, typename Tag>
@@ -142,6 +165,19 @@ public:
         return it == std::end(mappings_) ? 0u : it->second;
     }
 private:
+    using coord_table = flat_table<uint32_t, point2i16>;
+
+    point2i16 index_to_coord_(uint32_t const i) const noexcept {
+        return underlying_cast_unsafe<int16_t>(index_to_rect(i).top_left());
+    }
+
+    point2i16 lookup_(coord_table const& table, uint32_t const id) const noexcept {
+        auto const p = table.find(id);
+        return p ? *p : index_to_coord_(0);
+    }
+
+    void update_mapped_coords_() const;
+
     tile_map_type type_;
     uint32_t      texture_id_ {0};
 
@@ -151,6 +187,10 @@ private:
     sizei32y tiles_y_;
 
     std::unordered_map<uint32_t, uint32_t> mappings_;
+
+    coord_table         tile_coords_;   //!< for every tile_id
+    coord_table mutable mapped_coords_; //!< for every id in mappings_
+    bool        mutable mapped_coords_stale_ {true};
 };
 
 uint32_t id_to_index(tile_map const& map, tile_id id) noexcept;
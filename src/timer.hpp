@@ -45,24 +45,32 @@ public:
         return add(hash, period, 0, std::move(callback));
     }
 
-    //! @pre new timers cannot be added as a result of calling update().
+    //! Timers added as a result of calling update() are first considered by
+    //! the next call to update().
     key_t add(
         uint32_t   const hash     //!< the 32-bit identifier (string hash)
       , duration   const period   //!< the period of the timer
       , timer_data const data     //!< timer specific, user-defined data
       , callback_t       callback //!< the timer action
     ) {
-        BK_ASSERT(!updating_
-            && period.count() >= 0
+        BK_ASSERT(period.count() >= 0
             && !!callback
             && !!hash
-            && (std::find(begin(timers_), end(timers_), hash) == end(timers_)));
+            && (std::find(begin(timers_), end(timers_), hash) == end(timers_))
+            && (std::find(begin(added_),  end(added_),  hash) == end(added_)));
 
+        // the callback being run by update() is moved out of the storage for
+        // the duration of the call, so this is fine even if it grows.
         auto const result = callbacks_.allocate(std::move(callback));
         auto const key    = key_t {static_cast<uint32_t>(result.second), hash};
+        auto const t      = data_t {data, clock_t::now() + period, key};
 
-        timers_.push_back({data, clock_t::now() + period, key});
-        std::push_heap(begin(timers_), end(timers_), predicate_);
+        if (updating_) {
+            added_.push_back(t);
+        } else {
+            timers_.push_back(t);
+            std::push_heap(begin(timers_), end(timers_), predicate_);
+        }
 
         return key;
     }
@@ -101,18 +109,29 @@ public:
         return remove_(hash);
     }
 
+    //! The earliest deadline of any timer, or time_point::max() if there are
+    //! none; a time already passed if a timer is ready.
+    time_point next_deadline() const noexcept {
+        return timers_.empty()
+          ? time_point::max()
+          : timers_.front().deadline;
+    }
+
     //! Trigger any ready timers.
-    void update() {
+    //! @returns The number of callbacks invoked.
+    size_t update() {
         if (timers_.empty()) {
-            return;
+            return 0;
         }
 
         updating_ = true;
         auto on_exit = BK_SCOPE_EXIT {
             updating_ = false;
+            merge_added_();
         };
 
         auto const now = clock_t::now();
+        size_t count = 0;
 
         // remove "dead" timers that were marked as such by remove(). Timers
         // enter this state if they are removed during a callback.
@@ -147,7 +166,9 @@ public:
             auto& t = timers_.front();
             auto const key = t.key;
 
-            auto const period = callbacks_[t.key.index](dt, t.data);
+            auto const period = invoke_(t.key.index, dt, t.data);
+            ++count;
+
             BK_ASSERT(period.count() >= 0
                    && !timers_.empty()
                    && timers_.front().key == key);
@@ -177,6 +198,8 @@ public:
             timers_.back() = data;
             std::push_heap(first, last, predicate_);
         } while (!timers_.empty());
+
+        return count;
     }
 
 private:
@@ -202,8 +225,43 @@ private:
         return a.deadline > b.deadline;
     }
 
+    //! Run the callback with id @p i; it is held apart from callbacks_ while
+    //! it runs as it may add new timers.
+    duration invoke_(uint32_t const i, duration const dt, timer_data& data) {
+        auto callback = std::move(callbacks_[i]);
+        auto on_exit = BK_SCOPE_EXIT {
+            callbacks_[i] = std::move(callback);
+        };
+
+        return callback(dt, data);
+    }
+
+    //! Move the timers added during update() onto the heap; those removed in
+    //! the meantime are dropped.
+    void merge_added_() noexcept {
+        for (auto const& t : added_) {
+            if (t.deadline == time_point {}) {
+                callbacks_.deallocate(t.key.index);
+                continue;
+            }
+
+            timers_.push_back(t);
+            std::push_heap(begin(timers_), end(timers_), predicate_);
+        }
+
+        added_.clear();
+    }
+
     template <typename Key>
     bool remove_(Key const& key) noexcept {
+        if (updating_) {
+            auto const it = std::find(begin(added_), end(added_), key);
+            if (it != end(added_)) {
+                it->deadline = time_point {};
+                return true;
+            }
+        }
+
         auto const first = begin(timers_);
         auto const last  = end(timers_);
         auto const it    = std::find(first, last, key);
@@ -231,6 +289,7 @@ private:
     }
 
     std::vector<data_t> timers_;
+    std::vector<data_t> added_; //!< timers added during update()
     contiguous_fixed_size_block_storage<callback_t> callbacks_;
     bool updating_ = false;
 };
@@ -19,6 +19,7 @@ struct tag_id_instance_item   {};
 struct tag_id_property_item   {};
 struct tag_id_region          {};
 struct tag_id_body_part       {};
+struct tag_id_behavior        {};
 
 using region_id = tagged_value<uint16_t, tag_id_region>;
 
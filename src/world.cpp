@@ -54,6 +54,32 @@ public:
         return unique_entity {id, entity_deleter_};
     }
 
+    void create_objects(
+        game_database   const&    db
+      , item_definition const&    def
+      , random_state&             rng
+      , size_t const              n
+      , std::vector<unique_item>& out
+    ) final override {
+        create_objects_(items_, item_deleter_, n, out
+          , [&](item_instance_id const id) -> std::pair<item*, size_t> {
+                return items_.allocate(item_deleter_, db, def, id, rng);
+            });
+    }
+
+    void create_objects(
+        game_database     const&    db
+      , entity_definition const&    def
+      , random_state&               rng
+      , size_t const                n
+      , std::vector<unique_entity>& out
+    ) final override {
+        create_objects_(entities_, entity_deleter_, n, out
+          , [&](entity_instance_id const id) -> std::pair<entity*, size_t> {
+                return entities_.allocate(item_deleter_, db, def, id, rng);
+            });
+    }
+
     int total_levels() const noexcept final override {
         return static_cast<int>(levels_.size());
     }
@@ -73,6 +99,13 @@ public:
         return it != end(levels_);
     }
 
+    level* find_level(size_t const id) noexcept final override {
+        auto const it = std::find_if(begin(levels_), end(levels_)
+          , [&](auto const& lvl) noexcept { return lvl->id() == id; });
+
+        return it != end(levels_) ? it->get() : nullptr;
+    }
+
     level& add_new_level(level* parent, std::unique_ptr<level> level) final override {
         levels_.push_back(std::move(level));
         return *levels_.back();
@@ -86,6 +119,29 @@ public:
         return current_level();
     }
 private:
+    template <typename Storage, typename Deleter, typename Handle, typename Allocate>
+    static void create_objects_(
+        Storage&             storage
+      , Deleter const&       deleter
+      , size_t const         n
+      , std::vector<Handle>& out
+      , Allocate             allocate
+    ) {
+        using id_t = typename Handle::pointer;
+
+        storage.reserve(n);
+        out.reserve(out.size() + n);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto const id = id_t {static_cast<uint32_t>(storage.next_block_id())};
+            auto const result = allocate(id);
+
+            BK_ASSERT(value_cast<size_t>(id) == result.second);
+
+            out.emplace_back(id, deleter);
+        }
+    }
+
     item_deleter   item_deleter_   {*this};
     entity_deleter entity_deleter_ {*this};
 
@@ -162,6 +218,28 @@ unique_entity create_object(world& w, std::function<entity (entity_instance_id)>
     return w.create_object(f);
 }
 
+void create_objects(
+    game_database const&      db
+  , world&                    w
+  , item_definition const&    def
+  , random_state&             rng
+  , size_t const              n
+  , std::vector<unique_item>& out
+) {
+    w.create_objects(db, def, rng, n, out);
+}
+
+void create_objects(
+    game_database const&        db
+  , world&                      w
+  , entity_definition const&    def
+  , random_state&               rng
+  , size_t const                n
+  , std::vector<unique_entity>& out
+) {
+    w.create_objects(db, def, rng, n, out);
+}
+
 item_deleter const& get_item_deleter(world const& w) noexcept {
     return w.get_item_deleter();
 }
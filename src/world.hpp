@@ -3,10 +3,15 @@
 #include "types.hpp"
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace boken { class item; }
 namespace boken { class entity; }
 namespace boken { class level; }
+namespace boken { class game_database; }
+namespace boken { class random_state; }
+namespace boken { struct item_definition; }
+namespace boken { struct entity_definition; }
 
 namespace boken {
 
@@ -43,12 +48,30 @@ public:
 
     //@}
 
+    //@{
+    //! Construct @p n new objects of the type given by @p def in place, and
+    //! append an owning handle for each to @p out (in order of creation).
+    //! Storage for all @p n objects is reserved up front.
+    //! @note    References returned by @ref find can be invalidated by a call
+    //!          to this function.
+
+    virtual void create_objects(game_database const& db, item_definition const& def
+      , random_state& rng, size_t n, std::vector<unique_item>& out) = 0;
+    virtual void create_objects(game_database const& db, entity_definition const& def
+      , random_state& rng, size_t n, std::vector<unique_entity>& out) = 0;
+
+    //@}
+
     virtual int total_levels() const noexcept = 0;
 
     virtual level&       current_level()       noexcept = 0;
     virtual level const& current_level() const noexcept = 0;
 
     virtual bool   has_level(size_t const id) const noexcept = 0;
+
+    //! @returns The level with the given id, otherwise nullptr.
+    virtual level* find_level(size_t const id) noexcept = 0;
+
     virtual level& add_new_level(level* parent, std::unique_ptr<level> level) = 0;
     virtual level& change_level(size_t const id) = 0;
 };